@@ -81,10 +81,10 @@ int main
 	 fprintf(stderr, "%s: can't open: %s\n", argv[optind], strerror(errno));
 	 exit(1);
       }
-      init_parser(&LANGUAGE_IDENTIFIER, fd, &perform_action, &install_token);
+      init_parser(&LANGUAGE_IDENTIFIER, fd, MAXBUFFER, &perform_action, &install_token);
    }
    else
-      init_parser(&LANGUAGE_IDENTIFIER, fileno(stdin), &perform_action, &install_token);
+      init_parser(&LANGUAGE_IDENTIFIER, fileno(stdin), MAXBUFFER, &perform_action, &install_token);
    LANGUAGE_IDENTIFIER.listing = listing;
 
    parse_input(&LANGUAGE_IDENTIFIER);
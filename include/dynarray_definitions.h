@@ -26,6 +26,7 @@ typedef struct dynarray dynarray;
 #define DYNELEMENT(a)		((a).element)
 #define DYNCOUNT(a)		((a).count)
 #define DYNSIZE(a)		((a).size)
+#define DYNRING(t, a, i)	(((t *) (a).array)[((a).first + (i)) & ((a).size - 1)])
 
 
 struct dynarray
@@ -33,6 +34,7 @@ struct dynarray
    int	  element;	/* Size of an array element */
    int	  count;	/* Number of array elements in use */
    int	  size;		/* Total number of array elements */
+   int	  first;	/* Index of first element of a ring buffer */
    void	 *array;	/* Dynamically resizeable array */
 };
 #endif /* _INCLUDED_DYNARRAY_DEFINITIONS_H */
@@ -28,4 +28,6 @@ extern bool dyncheck(dynarray *, int);
 extern void dyncopy(dynarray *, dynarray *);
 extern void dynfree(dynarray *);
 extern void dynresize(dynarray *, int);
+extern bool dynringcheck(dynarray *, int);
+extern void dynrotate(dynarray *, int);
 #endif /* _INCLUDED_DYNARRAY_FUNCTIONS_H */
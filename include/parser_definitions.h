@@ -28,9 +28,25 @@ typedef struct parseentry  parseentry;
 typedef struct reduceentry reduceentry;
 typedef struct insertentry insertentry;
 typedef struct errorrepair errorrepair;
+typedef struct reader	   readerentry;
+typedef struct failure	   failentry;
+typedef struct scanstate   stateentry;
+typedef struct nfa	   nfaentry;
+typedef struct lazystate   lazyentry;
+typedef struct cache	   cacheentry;
+typedef struct keyword	   keywordentry;
+typedef struct span	   spanentry;
+typedef struct chunk	   chunkentry;
+typedef struct parallel	   parallelentry;
+typedef struct scanned	   scannedentry;
+typedef struct pipeline	   pipelineentry;
+typedef struct table	   tableentry;
 
 
+#include <pthread.h>
+#include <semaphore.h>
 #include <stdbool.h>
+#include <stdint.h>
 
 #include "dynarray_definitions.h"
 
@@ -39,7 +55,23 @@ typedef struct errorrepair errorrepair;
 
 #define ENDFILE			256	/* Used to represent end of file */
 
-#define MAXBUFFER		8192	/* Amount of data read from file in one read */
+#define MAXBUFFER		8192	/* Default amount of data read from file in one read */
+
+/* Each piece of a mapped file is unmapped on its own, so MAXMAPPING */
+/* must stay a multiple of the page size			     */
+
+#define MAXMAPPING		(1 << 30) /* Largest piece of a mapped file in one buffer */
+
+#define MAXKEPTLINE		(1 << 20) /* Longest line start kept for an error message */
+
+#define LAZYSTATES		1024	/* Default number of lazily built scanner states kept */
+#define SCANCHUNK		(1 << 20) /* Input scanned by each thread in one parallel round */
+
+/* Input buffer types */
+
+#define READ_BUFFER		0	/* Buffer filled by reading the input file */
+#define MAPPED_BUFFER		1	/* Buffer is the memory mapped input file */
+#define MEMORY_BUFFER		2	/* Buffer is caller owned memory */
 
 /* Shift state numbers are encoded as SHIFT_OFFSET + state number.	      */
 /* Shiftreduce production numbers are encoded directly as the production      */
@@ -51,6 +83,19 @@ typedef struct errorrepair errorrepair;
 #define SHIFT_OFFSET		10000
 #define ACCEPT_OFFSET		-10000
 
+/* Integer types in which tableformat may store a packed table */
+
+#define UINT8_TABLE		1
+#define UINT16_TABLE		2
+#define INT16_TABLE		3
+#define INT32_TABLE		4
+
+/* Entry i of a packed table, whichever type it is stored in */
+
+#define TABLE(t, i)		((t).type == UINT8_TABLE  ? ((uint8_t *)  (t).entries)[i] : \
+				 (t).type == UINT16_TABLE ? ((uint16_t *) (t).entries)[i] : \
+				 (t).type == INT16_TABLE  ? ((int16_t *)  (t).entries)[i] : ((int32_t *) (t).entries)[i])
+
 /* Parsing actions decoded from the table entries */
 
 #define ERROR			0
@@ -59,6 +104,10 @@ typedef struct errorrepair errorrepair;
 #define REDUCE			3
 #define ACCEPT			4
 
+/* Absolute offset of a location from the start of the input */
+
+#define POSITION(l)	((l).buffer->start + (l).offset)
+
 #define MAXCOST		99999	/* Maximum error correction cost */
 
 /* Initial dynamic array sizes */
@@ -66,6 +115,7 @@ typedef struct errorrepair errorrepair;
 #define INITIAL_MSGQUEUE_SIZE	4
 #define INITIAL_PARSTACK_SIZE	8
 #define INITIAL_REDQUEUE_SIZE	8
+#define INITIAL_REDSTATE_SIZE	8
 #define INITIAL_TKNQUEUE_SIZE	8
 #define INITIAL_ERRSTACK_SIZE	8
 #define INITIAL_LCLSTACK_SIZE	8
@@ -74,6 +124,12 @@ typedef struct errorrepair errorrepair;
 #define INITIAL_SCNSTACK_SIZE	4
 #define INITIAL_DELETION_SIZE	4
 #define INITIAL_INSERTION_SIZE	4
+#define INITIAL_FAILPATH_SIZE	8
+#define INITIAL_FAILTABLE_SIZE	256
+#define INITIAL_CACHE_SIZE	64
+#define INITIAL_LAZYSET_SIZE	256
+#define INITIAL_LAZYTOKEN_SIZE	64
+#define INITIAL_SPANS_SIZE	1024
 
 /* Access definitions for dynamic arrays */
 
@@ -81,7 +137,7 @@ typedef struct errorrepair errorrepair;
 #define CHRELEMENT	(DYNELEMENT(tables->chrstring))
 #define	CHRCOUNT	(DYNCOUNT(tables->chrstring))
 #define CHRSIZE		(DYNSIZE(tables->chrstring))
-#define	MSGQUEUE(i)	(DYNARRAY(errorentry, tables->msgqueue,  (i)))
+#define	MSGQUEUE(i)	(DYNRING(errorentry,  tables->msgqueue,  (i)))
 #define MSGELEMENT	(DYNELEMENT(tables->msgqueue))
 #define	MSGCOUNT	(DYNCOUNT(tables->msgqueue))
 #define MSGSIZE		(DYNSIZE(tables->msgqueue))
@@ -93,7 +149,9 @@ typedef struct errorrepair errorrepair;
 #define REDELEMENT	(DYNELEMENT(tables->redqueue))
 #define	REDCOUNT	(DYNCOUNT(tables->redqueue))
 #define REDSIZE		(DYNSIZE(tables->redqueue))
-#define TKNQUEUE(i)	(DYNARRAY(tokenentry,  tables->tknqueue,  (i)))
+#define REDSTATE(i)	(DYNARRAY(int,         tables->redstate,  (i)))
+#define REDSTATESIZE	(DYNSIZE(tables->redstate))
+#define TKNQUEUE(i)	(DYNRING(tokenentry,   tables->tknqueue,  (i)))
 #define TKNELEMENT	(DYNELEMENT(tables->tknqueue))
 #define	TKNCOUNT	(DYNCOUNT(tables->tknqueue))
 #define TKNSIZE		(DYNSIZE(tables->tknqueue))
@@ -125,14 +183,72 @@ typedef struct errorrepair errorrepair;
 #define INSELEMENT	(DYNELEMENT(tables->insertion))
 #define	INSCOUNT	(DYNCOUNT(tables->insertion))
 #define INSSIZE		(DYNSIZE(tables->insertion))
+#define FAILPATH(i)	(DYNARRAY(failentry,   tables->failpath,  (i)))
+#define FAILELEMENT	(DYNELEMENT(tables->failpath))
+#define	FAILCOUNT	(DYNCOUNT(tables->failpath))
+#define FAILSIZE	(DYNSIZE(tables->failpath))
+#define LAZYSET(i)	(DYNARRAY(int,         tables->cache->positions, (i)))
+#define	LAZYSETCOUNT	(DYNCOUNT(tables->cache->positions))
+#define LAZYSETSIZE	(DYNSIZE(tables->cache->positions))
+#define LAZYTOKEN(i)	(DYNARRAY(int,         tables->cache->tokens,    (i)))
+#define	LAZYTOKENCOUNT	(DYNCOUNT(tables->cache->tokens))
+#define LAZYTOKENSIZE	(DYNSIZE(tables->cache->tokens))
+#define SPANS(i)	(DYNARRAY(spanentry,   chunk->spans, (i)))
+#define	SPANCOUNT	(DYNCOUNT(chunk->spans))
+#define SPANSIZE	(DYNSIZE(chunk->spans))
 
 
 struct buffer			/* One block of data from the file */
 {
    struct buffer *next;		/* Next input buffer in list */
-   int		  order;	/* Input buffer sequence number */
+   long long	  start;	/* Input offset of the first byte in the buffer */
    int		  count;	/* Amount of data in the buffer */
-   unsigned char  buffer[MAXBUFFER]; /* Data read from file */
+   int		  type;		/* READ_BUFFER, MAPPED_BUFFER, or MEMORY_BUFFER */
+   unsigned char *buffer;	/* Data read from file */
+};
+
+/* Buffers are passed between the scanner and the read ahead thread   */
+/* through two single producer, single consumer circular queues.  The */
+/* semaphores count the entries in each queue and order the accesses, */
+/* so only one side ever changes each index			      */
+
+struct reader			/* Read ahead thread and its buffer queues */
+{
+   pthread_t	 thread;	/* Thread filling input buffers */
+   int		 size;		/* Number of entries in each queue */
+   bufferentry **filled;	/* Buffers read by the thread */
+   int		 fillhead;	/* Next filled buffer for the scanner */
+   int		 filltail;	/* Next free slot for the thread */
+   sem_t	 fillcount;	/* Number of filled buffers waiting */
+   sem_t	 fillspace;	/* Number of free filled buffer slots */
+   bufferentry **spare;		/* Buffers released by the scanner */
+   int		 sparehead;	/* Next spare buffer for the thread */
+   int		 sparetail;	/* Next free slot for the scanner */
+   sem_t	 sparecount;	/* Number of spare buffers waiting */
+   sem_t	 sparespace;	/* Number of free spare buffer slots */
+};
+
+/* The scanner data input_token needs for each state, gathered into one	*/
+/* entry so that a state touches a single cache line.  Written by the	*/
+/* tableformat -f option, entry 0 is unused just as in the state arrays	*/
+
+struct scanstate		/* Scanner data for one state */
+{
+   int		 sbase;		/* Index of transitions in snext */
+   int		 sdefault;	/* Default state (0 if none or direct indexed) */
+   int		 tokenindex;	/* Index of end of token values in tokentable */
+   short	 final;		/* Final token value (0 if not a final state) */
+   unsigned char tokencount;	/* Number of end of token values */
+   bool		 loop;		/* True if the state has self loop byte ranges */
+};
+
+/* A packed scanner or parser table, which tableformat stores in the */
+/* narrowest integer type that holds all of its values		     */
+
+struct table			/* Packed table of integers */
+{
+   int	 type;			/* Type of the entries (UINT8_TABLE through INT32_TABLE) */
+   void *entries;		/* Table entries (NULL if the table is not present) */
 };
 
 struct location			/* Position within an input buffer */
@@ -157,7 +273,7 @@ struct tokenentry		/* One entry on the token stack */
 {
    int		  token;	/* Token number for parser */
    unsigned char *symbol;	/* Token string (if installed) */
-   location	  locus;	/* Start of containing line */
+   int		  length;	/* Length of token string */
    location	  where;	/* Token start position */
 };
 
@@ -176,6 +292,7 @@ struct parseentry		/* One entry on the parse stack */
    location	  where;	/* Start of token which created this entry */
    int		  token;	/* Token number */
    unsigned char *symbol;	/* Token string (if installed) */
+   int		  length;	/* Length of token string */
 };
 
 struct reduceentry		/* One entry in the reduce queue */
@@ -189,6 +306,7 @@ struct insertentry		/* One entry in the continuation string */
 {
    int		  token;	/* Token number */
    unsigned char *symbol;	/* Symbol string if appropriate */
+   int		  length;	/* Length of symbol string */
    int		  cost;		/* Cost up to this token */
    bool		  known;	/* TRUE if Followset known */
 };
@@ -199,4 +317,140 @@ struct errorrepair		/* Possible error repair */
    int prefix;			/* Continuation prefix insertion */
    int cost;			/* Error repair cost */
 };
+
+struct failure			/* Scanner state that reaches no final state */
+{
+   long long position;		/* Input offset of the next character */
+   int	     state;		/* Scanner state number (0 if entry unused) */
+};
+
+/* A scanner may be given as the NFA from which sdtgen would build its */
+/* DFA.  The parser then builds only the DFA states the input reaches, */
+/* keeping them in a cache which is flushed between tokens once it     */
+/* holds more than lazystates states.  Positions are numbered from 1   */
+
+struct nfa			/* Scanner NFA for a lazily built DFA */
+{
+   int		  positions;	/* Number of NFA positions */
+   int		  classes;	/* Number of input character classes */
+   int		 *start;	/* Count of start positions followed by the positions */
+   int		 *token;	/* End of token value for each position */
+   int		 *final;	/* Final token value for each position */
+   char		 *install;	/* String matching token is recorded on parse stack */
+   unsigned char *classbits;	/* Bitmap of the classes each position transitions on */
+   int		 *followindex;	/* Index of each position's follow set in followtable */
+   int		 *followtable;	/* Concatenated follow sets */
+};
+
+struct lazystate		/* One scanner DFA state built from the NFA */
+{
+   int setindex;		/* Index of the state's positions in the position pool */
+   int setcount;		/* Number of positions in the state */
+   int tokenindex;		/* Index of end of token values in the token pool */
+   int tokencount;		/* Number of end of token values */
+   int link;			/* Next state in the same hash bucket */
+};
+
+struct cache			/* Scanner DFA states built so far */
+{
+   int		count;		/* Number of states built (state 0 unused) */
+   int		size;		/* Number of states allocated */
+   lazyentry   *states;		/* The states built */
+   int	       *final;		/* Final token value for each state */
+   char	       *install;	/* String matching token is recorded on parse stack */
+   int	       *next;		/* Next state by state and class (0 unknown, -1 none) */
+   int	       *bucket;		/* First state in each of 2 * size hash buckets */
+   dynarray	positions;	/* Pool of state position sets */
+   dynarray	tokens;		/* Pool of state end of token values */
+   int	       *merge;		/* Positions of the state being built */
+   int	       *mark;		/* Stamp of each position already merged */
+   int		stamp;		/* Current stamp for mark */
+};
+
+/* Keywords which the scanner would otherwise recognize as some other	*/
+/* token, usually an identifier, may be left out of the scanner states	*/
+/* and found instead by looking up the string of that token in a	*/
+/* minimal perfect hash table.  A keyword is in slot			*/
+/*									*/
+/*    hash_keyword(seed[hash_keyword(0, s) % buckets], s) % count	*/
+/*									*/
+/* with hash_keyword ignoring case, so keywords differing only in case	*/
+/* are never both looked up						*/
+
+struct keyword			/* Keyword lookup table */
+{
+   int	 count;			/* Number of keywords */
+   int	 buckets;		/* Number of first level hash buckets */
+   int	 maxlength;		/* Length of the longest keyword */
+   int	*seed;			/* Second level hash seed for each bucket */
+   int	*token;			/* Keyword token value in each slot */
+   int	*base;			/* Token whose string is looked up for each slot */
+   char *install;		/* String matching keyword is recorded on parse stack */
+   char *fold;			/* Keyword in each slot is case insignificant */
+   int	*nameindex;		/* Index of each slot's keyword in nametable */
+   char *nametable;		/* Concatenated keywords */
+   char *check;			/* True for each token whose string may be a keyword */
+};
+
+/* scan_tokens may split the input among several threads, each running	*/
+/* a private copy of the scanner over its own chunk.  A chunk after the	*/
+/* first begins just past a newline, which is only a guess at a token	*/
+/* boundary, so its tokens are used only from the first one which	*/
+/* starts where the tokens of the previous chunk leave off		*/
+
+struct span			/* One token found in a chunk */
+{
+   int	     token;		/* Token number */
+   int	     length;		/* Length of token string */
+   long long start;		/* Input offset of the token */
+};
+
+struct chunk			/* A piece of the input scanned by one thread */
+{
+   pthread_t		thread;		/* Thread scanning the chunk */
+   struct sdt_tables   *tables;		/* Private copy of the scanner data */
+   long long		limit;		/* Tokens starting here or later belong to the next chunk */
+   long long		stop;		/* Start of the first token not recorded */
+   bool			endfile;	/* True if scanning stopped at end of file */
+   dynarray		spans;		/* Tokens found in the chunk */
+   int			first;		/* Next token to be returned */
+   int			message;	/* Next error message to be returned */
+};
+
+struct parallel			/* Chunks scanned by parallel threads */
+{
+   int	       size;		/* Number of chunks allocated */
+   int	       count;		/* Number of chunks in the current round */
+   int	       next;		/* Chunk whose tokens are being returned */
+   bool	       endfile;		/* True once a round has reached end of file */
+   chunkentry *chunk;		/* One chunk for each thread */
+};
+
+/* When scanahead is set the scanner runs in a thread of its own ahead */
+/* of the parser, with a private copy of the scanner data.  It passes  */
+/* tokens and lexical errors to the parser through a single producer,  */
+/* single consumer circular queue ordered by two semaphores, just as   */
+/* the read ahead thread passes buffers to the scanner		       */
+
+struct scanned			/* One token or lexical error found by the scanner thread */
+{
+   int	    token;		/* Token number (0 for a lexical error) */
+   char	    install;		/* True if the token string is recorded */
+   location where;		/* Start of the token or the first erroneous character */
+   location end;		/* End of the token or the last erroneous character */
+};
+
+struct pipeline			/* Scanner thread and its token queue */
+{
+   pthread_t		thread;		/* Thread scanning the input */
+   struct sdt_tables   *tables;		/* Private copy of the scanner data */
+   int			size;		/* Number of entries in the queue */
+   scannedentry	       *queue;		/* Tokens and errors found by the thread */
+   int			head;		/* Next entry for the parser */
+   int			tail;		/* Next free entry for the thread */
+   sem_t		fillcount;	/* Number of entries waiting */
+   sem_t		fillspace;	/* Number of free entries */
+   bool			endfile;	/* True once the end of file token has been taken */
+   scannedentry		last;		/* End of file token, returned again when asked */
+};
 #endif /* _INCLUDED_PARSER_DEFINITIONS_H */
@@ -23,9 +23,13 @@
 #include "tables_definitions.h"
 
 
-extern void	  free_parser(sdt_tables *);
-extern void	  init_parser(sdt_tables *, int, void (*)(sdt_tables *, int), void (*)(sdt_tables *, tokenentry *));
-extern nameentry *lookup_token(sdt_tables *, unsigned char *, int, int);
-extern void	  parse_input(sdt_tables *);
-extern void	  record_error(sdt_tables *, location *, char *, ...);
+extern unsigned char *copy_symbol(unsigned char *, int);
+extern void	      free_parser(sdt_tables *);
+extern void	      init_parser(sdt_tables *, int, int, void (*)(sdt_tables *, int), void (*)(sdt_tables *, tokenentry *));
+extern void	      init_parser_buffer(sdt_tables *, unsigned char *, long long, void (*)(sdt_tables *, int), void (*)(sdt_tables *, tokenentry *));
+extern nameentry     *lookup_token(sdt_tables *, unsigned char *, int, int);
+extern void	      parse_input(sdt_tables *);
+extern void	      record_error(sdt_tables *, location *, char *, ...);
+extern int	      scan_char(sdt_tables *, location *);
+extern int	      scan_tokens(sdt_tables *, int *, long long *, int *, int);
 #endif /* _INCLUDED_PARSER_FUNCTIONS_H */
@@ -42,6 +42,7 @@ typedef union parsetree treenode;
 #define ZEROBYTE	5
 #define ENDOFFILE	6
 #define SEMANTIC	7
+#define UNICLASS	8
 
 /* Defined kinds of internal nodes */
 
@@ -85,7 +86,7 @@ union parsetree /* One node in the parse tree */
       union
       {
 	 symbolentry   *symbol;		/* If type == REFERENCE */
-	 unsigned char *value;		/* If type == CHARACTER or CLASS */
+	 unsigned char *value;		/* If type == CHARACTER, CLASS, or UNICLASS */
 	 int		number;		/* If type == SEMANTIC */
       } value;
    } leaf;
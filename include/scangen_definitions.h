@@ -22,19 +22,28 @@
 typedef struct position   position;
 typedef struct transition transition;
 typedef struct dfastate   dfastate;
+typedef struct keytoken   keytoken;
 
 
 #include "dynarray_definitions.h"
 #include "intset_definitions.h"
+#include "partree_definitions.h"
+#include "symbols_definitions.h"
 
 
 #define INITIAL_DFA_SIZE	32
 #define INITIAL_NFASET_SIZE	8
 #define INITIAL_TOKENS_SIZE	4
 #define INITIAL_GROUP_SIZE	4
+#define INITIAL_KEYWORD_SIZE	16
 
 #define MAPCOUNT	(256 + 1)		/* All possible bytes plus EOF */
 #define MAPSIZE		(MAPCOUNT / 8 + 1)	/* Number of bytes in bitmap */
+#define UNICODECOUNT	0x110000		/* All Unicode code points */
+#define UNICODESIZE	(UNICODECOUNT / 8)	/* Number of bytes in code point bitmap */
+
+#define MAXLOOPRANGES	4		/* Most byte ranges in a state's self loop */
+#define MAXKEYSEED	65536		/* Most seeds tried for one keyword hash bucket */
 
 /* Bitmap set, clear, and test functions */
 
@@ -50,6 +59,10 @@ typedef struct dfastate   dfastate;
 #define	DFAELEMENT	(DYNELEMENT(tables->dfastates))
 #define	DFACOUNT	(DYNCOUNT(tables->dfastates))
 #define	DFASIZE		(DYNSIZE(tables->dfastates))
+#define	KEYTOKEN(i)	(DYNARRAY(keytoken, tables->keywordlist, (i)))
+#define	KEYELEMENT	(DYNELEMENT(tables->keywordlist))
+#define	KEYCOUNT	(DYNCOUNT(tables->keywordlist))
+#define	KEYSIZE		(DYNSIZE(tables->keywordlist))
 
 
 struct position			/* One important state in the NFA */
@@ -77,4 +90,13 @@ struct dfastate			/* One state in the DFA */
    transition *action;		/* Transitions out of this state */
    int	       count;		/* Transition count out of state */
 };
+
+struct keytoken			/* One keyword recognized by lookup */
+{
+   symbolentry *symbol;		/* Keyword token symbol */
+   treenode    *tree;		/* Definition of the keyword in the scanner syntax tree */
+   int		base;		/* Token the scanner returns for the keyword */
+   int		bucket;		/* First level hash bucket of the keyword */
+   int		slot;		/* Perfect hash table slot of the keyword */
+};
 #endif /* _INCLUDED_SCANGEN_DEFINITIONS_H */
@@ -28,5 +28,7 @@
 extern void free_scangen(sdt_tables *);
 extern void generate_scanner(sdt_tables *);
 extern bool init_scangen(sdt_tables *);
+extern void write_keywords(sdt_tables *, FILE *);
+extern void write_nfa(sdt_tables *, FILE *);
 extern void write_scanner(sdt_tables *, FILE *);
 #endif /* _INCLUDED_SCANGEN_FUNCTIONS_H */
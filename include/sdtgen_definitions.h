@@ -49,4 +49,5 @@
 #define DEFAULTREDUCE	0x0002	/* Use shiftreduce actions to reduce table size */
 #define	AMBIGUOUS	0x0004	/* Use precedence and associativity to resolve shift-reduce conflicts */
 #define SPLITSTATES	0x0008	/* Split states to resolve reduce-reduce conflicts */
+#define KEYWORDS	0x0010	/* Recognize keywords by lookup instead of scanner states */
 #endif /* _INCLUDED_SDTGEN_DEFINITIONS_H */
@@ -52,6 +52,7 @@ typedef struct dynarray	symbolset;
 #define CASE		0x0010
 #define ALIAS		0x0020
 #define EMPTY		0x0040
+#define KEYWORD		0x0080
 
 #define SYMBOLSET(v, i)	(DYNARRAY(symbolentry *, (v), (i)))
 #define SYMELEMENT(v)	(DYNELEMENT((v)))
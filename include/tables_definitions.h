@@ -23,6 +23,7 @@ typedef struct sdt_tables sdt_tables;
 
 
 #include <stdbool.h>
+#include <stddef.h>
 
 #include "dynarray_definitions.h"
 #include "lalrgen_definitions.h"
@@ -41,14 +42,18 @@ struct sdt_tables
    int		  ntnumber;		/* Number of nonterminal symbols in language */
    int		  context;		/* Number of error repair context tokens */
    int		  defcost;		/* Assumed default cost of an error repair */
+   bool		  lookahead;		/* True if any token has a lookahead expression */
    int		 *tokenindex;		/* Index of end of token values in tokentable */
    int		 *tokentable;		/* Concatenated end of token values */
    int		 *final;		/* Final token value for each scanner state */
    char		 *install;		/* String matching token is recorded on parse stack */
-   int		 *sdefault;		/* Default state for each compressed scanner state */
-   int		 *sbase;		/* Index of transitions for each compressed scanner state */
-   int		 *scheck;		/* State for which this transition is valid */
-   int		 *snext;		/* Next state index for this transition */
+   int		 *classmap;		/* Equivalence class of each input character */
+   tableentry	  sdefault;		/* Default state for each compressed scanner state (NULL if direct indexed) */
+   tableentry	  sbase;		/* Index of transitions for each compressed scanner state */
+   tableentry	  scheck;		/* State for which this transition is valid (NULL if direct indexed) */
+   tableentry	  snext;		/* Next state index for this transition */
+   int		 *loopindex;		/* Index of self loop byte ranges in looptable */
+   int		 *looptable;		/* Concatenated low and high bytes of self loop ranges */
    int		 *inscost;		/* Insertion cost for each terminal */
    int		 *delcost;		/* Deletion cost for each terminal */
    int		 *lhsymbol;		/* Nonterminal value for each production LHS */
@@ -57,9 +62,18 @@ struct sdt_tables
    int		 *repair;		/* Error repair token for each parser state */
    int		 *stringindex;		/* Index into stringtable for each token in language */
    char		 *stringtable;		/* Concatenated string of all token names */
-   int		 *pbase;		/* Index of actions for each compressed parser state */
-   int		 *pcheck;		/* Token for which this parsing action is valid */
-   int		 *pnext;		/* Parsing action for current state and input token */
+   tableentry	  pbase;		/* Index of actions for each compressed parser state */
+   tableentry	  pcheck;		/* Token for which this parsing action is valid */
+   tableentry	  pnext;		/* Parsing action for current state and input token */
+   tableentry	  gdefault;		/* Most common goto action for each nonterminal */
+   tableentry	  gbase;		/* Index of gotos for each compressed nonterminal column */
+   tableentry	  gcheck;		/* Nonterminal for which this goto action is valid */
+   tableentry	  gnext;		/* Goto action for current state and nonterminal */
+   int		  (*scancode)(sdt_tables *, int, location *);	/* Direct coded scanner (NULL if tables are interpreted) */
+   stateentry	 *scanstate;		/* Fused per state scanner data (NULL if not generated) */
+   nfaentry	 *nfa;			/* Scanner NFA for a lazily built DFA (NULL if not generated) */
+   keywordentry	 *keywords;		/* Keywords recognized by lookup (NULL if none) */
+   int		  (*parsecode)(int, int);	/* Direct coded parser (NULL if tables are interpreted) */
 
 /* Data for sdtgen scanner and parser */
 
@@ -67,21 +81,37 @@ struct sdt_tables
    void		  (*action)(sdt_tables *, int);
    void		  (*token)(sdt_tables *, tokenentry *);
    bool		  listing;		/* True if input listing to be generated */
+   bool		  slices;		/* True if token strings may point into the input */
+   bool		  memoize;		/* True if failed scanner states are remembered */
    bufferentry	 *bufferlist;		/* Linked list of input buffers */
    bufferentry	 *bufferend;		/* Last buffer in linked list */
+   bufferentry	 *bufferpool;		/* Free input buffers kept for reuse */
+   int		  buffersize;		/* Amount of data read from file in one read */
+   int		  readahead;		/* Number of buffers read ahead by a thread (0 for none) */
+   readerentry	 *reader;		/* Read ahead thread (NULL until started) */
+   int		  lazystates;		/* Lazily built scanner states kept between tokens */
+   cacheentry	 *cache;		/* Lazily built scanner states (NULL until needed) */
+   int		  scanthreads;		/* Number of threads scan_tokens may use (0 for none) */
+   parallelentry *parallel;		/* Parallel scanning threads (NULL until started) */
+   int		  scanahead;		/* Number of tokens the scanner thread may run ahead (0 for none) */
+   pipelineentry *pipeline;		/* Scanner thread feeding parse_input (NULL until started) */
+   failentry	 *failtable;		/* Hash table of failed scanner states (NULL until needed) */
+   int		  failsize;		/* Number of entries in failtable */
+   int		  failused;		/* Number of entries in failtable ever filled */
+   long long	  failmax;		/* Largest input offset in failtable */
    location	  position;		/* Current input buffer position */
-   bool		  newline;		/* True if the next character starts a line */
    bool		  endfile;		/* True after end of file detected */
    int		  lineno;		/* Number of last line written */
    location	  unwritten;		/* Beginning of first unwritten line */
+   location	  lineend;		/* Input searched for the end of the unwritten line */
    bool		  msgwritten;		/* True if error message has been written */
-   location	  beginning;		/* Beginning of current input line */
    location	 *tokenend;		/* End of token values */
    int		 *followset;		/* Minimal continuation insertion for valid token */
    dynarray	  chrstring;		/* Character array to build strings */
    dynarray	  msgqueue;		/* Error message queue */
    dynarray	  parstack;		/* Parse stack */
    dynarray	  redqueue;		/* Delayed reduces to simulate LR */
+   dynarray	  redstate;		/* State left at each stack position by delayed reduces */
    dynarray	  tknqueue;		/* Input token queue */
    dynarray	  errstack;		/* State stack at time of error */
    dynarray	  lclstack;		/* State stack used by repair_error */
@@ -90,6 +120,7 @@ struct sdt_tables
    dynarray	  scnstack;		/* Deletion candidate tokens */
    dynarray	  deletion;		/* Tokens actually deleted by repair */
    dynarray	  insertion;		/* Continuation automaton token string */
+   dynarray	  failpath;		/* Scanner states since the last final state */
    nameentry	 *nametable[HASH_TABLE_SIZE];	/* Hash table for name to token number map */
 #ifdef	  PARSER_STATS
    int		  buffercount;		/* Number of buffers currently in use */
@@ -106,6 +137,7 @@ struct sdt_tables
 /* Data used by the scanner and parser generator */
 
    int		  display;		/* Selected display options */
+   bool		  lazy;			/* True if the scanner NFA is written for a lazily built DFA */
    int		  debug;		/* Debug flag bits */
    bool		  process;		/* True if scanner and parser tables should be generated */
    int		  options;		/* Option flags set by input grammar */
@@ -130,6 +162,11 @@ struct sdt_tables
    dynarray	  nfapositions;		/* Sets of follow positions in NFA */
    dynarray	  dfastates;		/* Deterministic automaton state table */
    int		  dfacount;		/* Number of DFA states in scanner */
+   int		 *charclass;		/* Equivalence class of each input character */
+   int		  classcount;		/* Number of input character classes */
+   int		  lookaheads;		/* Number of tokens with a lookahead expression */
+   intset	  nfastart;		/* First positions of the NFA for a lazily built DFA */
+   dynarray	  keywordlist;		/* Tokens recognized by keyword lookup */
 
 /* Data used to create the parser being defined */
 
@@ -23,7 +23,10 @@
 
 
 extern int  char_width(int, int, int);
+extern int  decode_utf8(unsigned char **);
 extern void display_char(int, int, FILE *);
+extern int  encode_utf8(int, unsigned char *);
+extern unsigned int hash_keyword(unsigned int, unsigned char *, int);
 extern int  hash_string(unsigned char *);
 extern void out_of_memory(void);
 #endif /* _INCLUDED_UTILITY_FUNCTIONS_H */
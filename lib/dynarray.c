@@ -40,6 +40,7 @@ void dynalloc
       array->element = element;
       array->count   = 0;
       array->size    = size;
+      array->first   = 0;
    }
    else
       out_of_memory();
@@ -90,6 +91,7 @@ void dynfree
    array->element = 0;
    array->count   = 0;
    array->size    = 0;
+   array->first   = 0;
 }
 
 
@@ -110,3 +112,44 @@ void dynresize
    else
       out_of_memory();
 }
+
+
+bool dynringcheck
+(
+   dynarray *array,
+   int	     count
+)
+{
+/* Enlarge a ring buffer, whose size is a power of two, if it cannot hold */
+/* count elements.  The elements which have wrapped around to the start  */
+/* of the array are moved to just past its old end			  */
+
+   int size;				/* Old size of the array */
+   int wrap;				/* Number of elements wrapped to the start */
+
+   if (count <= array->size)
+      return(false);
+
+   for (size = array->size; array->size < count; array->size *= 2)
+      ;
+   if (!(array->array = realloc(array->array, array->size * array->element)))
+      out_of_memory();
+
+   if ((wrap = array->first + array->count - size) > 0)
+      memcpy((char *) array->array + size * array->element, array->array, wrap * array->element);
+   return(true);
+}
+
+
+void dynrotate
+(
+   dynarray *array,
+   int	     count
+)
+{
+/* Remove count elements from the front of a ring buffer, or make room */
+/* for -count elements before the first if count is negative	       */
+
+   array->first  = (array->first + count) & (array->size - 1);
+   array->count -= count;
+}
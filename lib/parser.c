@@ -16,12 +16,21 @@
 /* You should have received a copy of the GNU General Public License along    */
 /* with this program.  If not, see <https://www.gnu.org/licenses/>.	      */
 
+#include <errno.h>
+#include <limits.h>
+#include <pthread.h>
+#include <semaphore.h>
 #include <stdarg.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <unistd.h>
+#ifdef	  __SSE2__
+#include <emmintrin.h>
+#endif /* __SSE2__ */
 
 #include "parser_definitions.h"
 #include "tables_definitions.h"
@@ -32,20 +41,111 @@
 #include "utility_functions.h"
 
 
-static void append_message(sdt_tables *, char *, ...);
-static void build_continuation(sdt_tables *);
-static int  decode_action(sdt_tables *, int, int, int *);
-static int  decode_goto(sdt_tables *, int, int, int *);
-static void enqueue_error(sdt_tables *, location *, char *);
-static int  error_value(sdt_tables *);
-static int  input_char(sdt_tables *, location *);
-static void input_token(sdt_tables *);
-static int  look_ahead(sdt_tables *, int, int, int);
-static void perform_reduces(sdt_tables *, location *);
-static bool read_buffer(sdt_tables *, location *);
-static void record_repair(sdt_tables *, int);
-static void repair_error(sdt_tables *);
-static void write_line(sdt_tables *);
+static bufferentry *acquire_buffer(sdt_tables *, long long);
+static bufferentry *allocate_buffer(long long, int);
+static void	    append_message(sdt_tables *, char *, ...);
+static void	    build_continuation(sdt_tables *);
+static int	    build_state(sdt_tables *, int);
+static int	    compare_positions(const void *, const void *);
+static sdt_tables  *copy_scanner(sdt_tables *);
+static int	    count_lines(unsigned char *, int, int, int *);
+static int	    decode_action(sdt_tables *, int, int, int *);
+static int	    decode_goto(sdt_tables *, int, int, int *);
+static void	    discard_buffer(void *);
+static void	    discard_lines(sdt_tables *, location *);
+static void	    drop_buffers(sdt_tables *);
+static void	    enqueue_error(sdt_tables *, location *, char *);
+static int	    error_value(sdt_tables *);
+static bool	    find_failure(sdt_tables *, int, long long);
+static int	    find_keyword(sdt_tables *, int);
+static bool	    find_newline(sdt_tables *, location *, location *);
+static void	    flush_cache(sdt_tables *);
+static void	    flush_lines(sdt_tables *, location *);
+static void	    free_buffer(bufferentry *);
+static void	    free_cache(sdt_tables *);
+static void	    free_scanner(sdt_tables *);
+static void	    free_symbol(sdt_tables *, unsigned char *);
+static void	    grow_cache(sdt_tables *);
+static unsigned int hash_failure(int, long long);
+static unsigned int hash_positions(int *, int);
+static int	    input_char(sdt_tables *, location *);
+static void	    input_token(sdt_tables *);
+static void	    locate_position(location *, long long);
+static int	    look_ahead(sdt_tables *, int, int, int);
+static bool	    map_input(sdt_tables *);
+static void	    move_messages(sdt_tables *, chunkentry *, long long);
+static int	    next_state(sdt_tables *, int, int);
+static void	    pass_token(pipelineentry *, int, char, location *, location *);
+static void	    perform_reduces(sdt_tables *, location *);
+static void	   *read_ahead(void *);
+static bool	    read_buffer(sdt_tables *, location *);
+static void	    receive_buffer(sdt_tables *, location *);
+static int	    receive_token(sdt_tables *, char *, location *);
+static void	    record_failures(sdt_tables *, long long);
+static void	    record_repair(sdt_tables *, int);
+static void	    release_buffer(sdt_tables *, bufferentry *);
+static void	    repair_error(sdt_tables *);
+static void	   *scan_ahead(void *);
+static void	   *scan_chunk(void *);
+static int	    scan_lazy(sdt_tables *, int, location *);
+static int	    scan_parallel(sdt_tables *, int *, long long *, int *, int);
+static void	    scan_round(sdt_tables *);
+static int	    scan_states(sdt_tables *, int, location *);
+static int	    scan_token(sdt_tables *, char *);
+static void	    setup_parser(sdt_tables *, void (*)(sdt_tables *, int), void (*)(sdt_tables *, tokenentry *));
+static void	    skip_run(sdt_tables *, int);
+static void	    start_cache(sdt_tables *);
+static void	    start_parallel(sdt_tables *);
+static void	    start_pipeline(sdt_tables *);
+static void	    start_reader(sdt_tables *);
+static void	    store_failure(sdt_tables *, failentry *, long long);
+static void	    write_line(sdt_tables *);
+
+
+static bufferentry *acquire_buffer
+(
+   sdt_tables *tables,
+   long long   start
+)
+{
+/* Take an input buffer from the free pool, or allocate one if it is empty */
+
+   bufferentry *buffer;
+
+   if (buffer = tables->bufferpool)
+   {
+      tables->bufferpool = buffer->next;
+
+      buffer->next  = NULL;
+      buffer->start = start;
+      buffer->count = 0;
+   }
+   else
+      buffer = allocate_buffer(start, tables->buffersize);
+   return(buffer);
+}
+
+
+static bufferentry *allocate_buffer
+(
+   long long start,
+   int	     size
+)
+{
+/* Allocate an input buffer header followed by room for size bytes of data */
+
+   bufferentry *buffer;
+
+   if (!(buffer = (bufferentry *) malloc(sizeof(*buffer) + size)))
+      out_of_memory();
+
+   buffer->next   = NULL;
+   buffer->start  = start;
+   buffer->count  = 0;
+   buffer->type   = READ_BUFFER;
+   buffer->buffer = (unsigned char *) &buffer[1];
+   return(buffer);
+}
 
 
 static void append_message
@@ -104,6 +204,7 @@ static void build_continuation
    INSERTION(0).known  = false;
    INSERTION(0).token  = 0;
    INSERTION(0).symbol = NULL;
+   INSERTION(0).length = 0;
    INSERTION(0).cost   = 0;
    INSCOUNT            = 1;
    for (i = 0; i <= tables->tnumber; i++)
@@ -153,6 +254,200 @@ static void build_continuation
 }
 
 
+static int build_state
+(
+   sdt_tables *tables,
+   int	       count			/* Number of positions in merge */
+)
+{
+/* Return the lazily built scanner state for the set of NFA positions  */
+/* in merge, building the state if it is not already in the cache.     */
+/* As sdtgen does, a state which is final for more than one token      */
+/* recognizes the token with the smallest value			       */
+
+   cacheentry	*cache;			/* Scanner states built so far */
+   nfaentry	*nfa;			/* Scanner NFA */
+   lazyentry	*entry;			/* State being built */
+   unsigned int	 bucket;		/* Hash bucket for the positions */
+   int		 state;			/* Scanner state number */
+   int		 token;			/* End of token or final value */
+   int		 i, j;
+
+   cache  = tables->cache;
+   nfa    = tables->nfa;
+   bucket = hash_positions(cache->merge, count) & (2 * cache->size - 1);
+
+   for (state = cache->bucket[bucket]; state; state = cache->states[state].link)
+      if (cache->states[state].setcount == count &&
+	  !memcmp(&LAZYSET(cache->states[state].setindex), cache->merge, count * sizeof(*cache->merge)))
+	 return(state);
+
+   if (cache->count >= cache->size)
+   {
+      grow_cache(tables);
+      bucket = hash_positions(cache->merge, count) & (2 * cache->size - 1);
+   }
+   state = cache->count++;
+   entry = &cache->states[state];
+
+/* Save the state's positions */
+
+   while (LAZYSETCOUNT + count > LAZYSETSIZE)
+      dynresize(&cache->positions, LAZYSETSIZE * 2);
+   entry->setindex = LAZYSETCOUNT;
+   entry->setcount = count;
+   memcpy(&LAZYSET(LAZYSETCOUNT), cache->merge, count * sizeof(*cache->merge));
+   LAZYSETCOUNT += count;
+
+/* Collect the tokens ending in this state and the token it recognizes */
+
+   entry->tokenindex     = LAZYTOKENCOUNT;
+   entry->tokencount     = 0;
+   cache->final[state]   = 0;
+   cache->install[state] = 0;
+   for (i = 0; i < count; i++)
+   {
+      if (token = nfa->token[cache->merge[i]])
+      {
+	 for (j = 0; j < entry->tokencount && LAZYTOKEN(entry->tokenindex + j) != token; j++)
+	    ;
+	 if (j == entry->tokencount)
+	 {
+	    dyncheck(&cache->tokens, LAZYTOKENSIZE * 2);
+	    LAZYTOKEN(LAZYTOKENCOUNT++) = token;
+	    entry->tokencount++;
+	 }
+      }
+      if ((token = nfa->final[cache->merge[i]]) && (!cache->final[state] || token < cache->final[state]))
+      {
+	 cache->final[state]   = token;
+	 cache->install[state] = nfa->install[cache->merge[i]];
+      }
+   }
+
+/* None of its transitions are known yet */
+
+   memset(&cache->next[state * nfa->classes], 0, nfa->classes * sizeof(*cache->next));
+
+   entry->link           = cache->bucket[bucket];
+   cache->bucket[bucket] = state;
+   return(state);
+}
+
+
+static int compare_positions
+(
+   const void *position1,
+   const void *position2
+)
+{
+/* Order NFA positions for qsort */
+
+   return(*(int *) position1 - *(int *) position2);
+}
+
+
+static sdt_tables *copy_scanner
+(
+   sdt_tables *tables
+)
+{
+/* Make a copy of the scanner data for a scanning thread.  The copy */
+/* shares the tables and the input buffers, but has its own	    */
+/* position, working arrays, and scanner caches			    */
+
+   sdt_tables *copy;
+
+   if (!(copy = (sdt_tables *) malloc(sizeof(*copy))))
+      out_of_memory();
+
+   *copy = *tables;
+   if (!(copy->tokenend = (location *) malloc((tables->ntokens + 2) * sizeof(*copy->tokenend))))
+      out_of_memory();
+
+   copy->listing   = false;
+   copy->readahead = 0;
+   copy->reader    = NULL;
+   copy->parallel  = NULL;
+   copy->scanahead = 0;
+   copy->pipeline  = NULL;
+   copy->cache     = NULL;
+   copy->failtable = NULL;
+   copy->failsize  = 0;
+   copy->failused  = 0;
+   copy->failmax   = -1;
+
+   dynalloc(&copy->chrstring, sizeof(char), 80);
+   dynalloc(&copy->msgqueue, sizeof(errorentry), INITIAL_MSGQUEUE_SIZE);
+   dynalloc(&copy->tknqueue, sizeof(tokenentry), INITIAL_TKNQUEUE_SIZE);
+   dynalloc(&copy->failpath, sizeof(failentry), INITIAL_FAILPATH_SIZE);
+   return(copy);
+}
+
+
+unsigned char *copy_symbol
+(
+   unsigned char *symbol,
+   int		  length
+)
+{
+/* Return a null terminated copy of a token string which the caller owns.  */
+/* Install and semantic routines use this to keep a string slice, which is */
+/* only a view into the input and is not null terminated		   */
+
+   unsigned char *string;
+
+   if (!symbol)
+      return(NULL);
+
+   if (!(string = malloc(length + 1)))
+      out_of_memory();
+
+   memcpy(string, symbol, length);
+   string[length] = '\0';
+   return(string);
+}
+
+
+static int count_lines
+(
+   unsigned char *data,
+   int		  offset,
+   int		  end,
+   int		 *last
+)
+{
+/* Count the newlines from offset up to end and set last to the offset */
+/* just past the final one.  Returns the number of newlines found      */
+
+   int	   count;		/* Number of newlines found */
+#ifdef	  __SSE2__
+   __m128i newline;		/* Sixteen newline characters */
+   int	   mask;		/* One bit for each newline in sixteen characters */
+#endif /* __SSE2__ */
+
+   count = 0;
+
+#ifdef	  __SSE2__
+   newline = _mm_set1_epi8('\n');
+   for (; offset + 16 <= end; offset += 16)
+      if (mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((__m128i *) &data[offset]), newline)))
+      {
+	 count += __builtin_popcount(mask);
+	 *last  = offset + 32 - __builtin_clz(mask);
+      }
+#endif /* __SSE2__ */
+
+   for (; offset < end; offset++)
+      if (data[offset] == '\n')
+      {
+	 count++;
+	 *last = offset + 1;
+      }
+   return(count);
+}
+
+
 static int decode_action
 (
    sdt_tables *tables,
@@ -166,28 +461,35 @@ static int decode_action
    int i;				/* Index into table for state/symbol */
    int next;				/* Next state or production number */
 
-   if (tables->pcheck[i = tables->pbase[state] + token] == state)
+/* A direct coded parser returns the table entry, or 0 if there is none */
 
-/*    The table entry is valid.  Decode it into an action and a state or production number */
+   if (tables->parsecode)
+      next = (*tables->parsecode)(state, token);
+   else
+   {
+      i    = TABLE(tables->pbase, state) + token;
+      next = (TABLE(tables->pcheck, i) == state) ? TABLE(tables->pnext, i) : 0;
+   }
 
-      if ((next = tables->pnext[i]) < 0)
-      {
-	 *entry = -next;
-	 return(REDUCE);
-      }
-      else
-	 if (next > SHIFT_OFFSET)
-	 {
-	    *entry = next - SHIFT_OFFSET;
-	    return(SHIFT);
-	 }
-	 else
-	 {
-	    *entry = next;
-	    return(SHIFTREDUCE);
-	 }
+/* If the table entry is valid, decode it into an action and a state or production number */
+
+   if (next < 0)
+   {
+      *entry = -next;
+      return(REDUCE);
+   }
+   else if (next > SHIFT_OFFSET)
+   {
+      *entry = next - SHIFT_OFFSET;
+      return(SHIFT);
+   }
+   else if (next)
+   {
+      *entry = next;
+      return(SHIFTREDUCE);
+   }
 
-/*    The table entry is invalid */
+/* The table entry is invalid */
 
    return(ERROR);
 }
@@ -203,13 +505,24 @@ static int decode_goto
 {
 /* Determine parsing action for this state and nonterminal symbol */
 
+   int i;				/* Index into table for state/nonterminal */
    int next;				/* Next state or production number */
 
-/* Since the nonterminal token was produced by a reduce the table entry it */
-/* selects must be valid.  It will be either shift/shiftreduce to process  */
-/* the nonterminal or the ACCEPT action					   */
+/* Since the nonterminal token was produced by a reduce the goto it selects */
+/* must be valid.  It is either the entry kept for this state or, if there  */
+/* is none, the nonterminal's default.  It will be either shift/shiftreduce */
+/* to process the nonterminal or the ACCEPT action			    */
+
+   if (tables->parsecode)
+      next = (*tables->parsecode)(state, token);
+   else
+   {
+      token -= tables->tnumber;
+      i     = TABLE(tables->gbase, token) + state;
+      next  = (TABLE(tables->gcheck, i) == token) ? TABLE(tables->gnext, i) : TABLE(tables->gdefault, token);
+   }
 
-   if ((next = tables->pnext[tables->pbase[state] + token]) > SHIFT_OFFSET)
+   if (next > SHIFT_OFFSET)
    {
       *entry = next - SHIFT_OFFSET;
       return(SHIFT);
@@ -228,6 +541,86 @@ static int decode_goto
 }
 
 
+static void discard_buffer
+(
+   void *buffer
+)
+{
+/* Free the buffer held by the read ahead thread if it is cancelled */
+
+   free(*(bufferentry **) buffer);
+}
+
+
+static void discard_lines
+(
+   sdt_tables *tables,
+   location   *where
+)
+{
+/* Used in place of flush_lines when nothing can be written.  Count the */
+/* lines in every buffer before the one containing where and release	*/
+/* them.  Only the buffers of the unwritten line are kept, and only	*/
+/* while that line is short enough to be worth displaying		*/
+
+   int count;				/* Number of lines counted */
+   int last;				/* Offset of the last line counted */
+
+   while (tables->lineend.buffer->start < where->buffer->start)
+   {
+      if (count = count_lines(tables->lineend.buffer->buffer, tables->lineend.offset, tables->lineend.buffer->count, &last))
+      {
+	 tables->lineno           += count;
+	 tables->unwritten.buffer  = tables->lineend.buffer;
+	 tables->unwritten.offset  = last;
+      }
+
+/*    A line that starts at the end of this buffer starts in the next one */
+
+      if (tables->unwritten.buffer == tables->lineend.buffer && tables->unwritten.offset >= tables->unwritten.buffer->count)
+      {
+	 tables->unwritten.buffer = tables->lineend.buffer->next;
+	 tables->unwritten.offset = 0;
+      }
+
+      tables->lineend.buffer = tables->lineend.buffer->next;
+      tables->lineend.offset = 0;
+   }
+
+/* The beginning of a very long line is dropped.  If an error turns up */
+/* later in the line, it is displayed from the first byte still kept   */
+
+   if (where->buffer->start - POSITION(tables->unwritten) > MAXKEPTLINE)
+      tables->unwritten = tables->lineend;
+
+   drop_buffers(tables);
+}
+
+
+static void drop_buffers
+(
+   sdt_tables *tables
+)
+{
+/* Any input buffers that precede the first unwritten line are no longer */
+/* needed, unless a string slice may still point into a mapped buffer	 */
+
+   bufferentry *buffer;
+
+   while (tables->bufferlist != tables->unwritten.buffer && (tables->bufferlist->type == READ_BUFFER || !tables->slices))
+   {
+      buffer             = tables->bufferlist;
+      tables->bufferlist = tables->bufferlist->next;
+
+      release_buffer(tables, buffer);
+
+#ifdef	  PARSER_STATS
+      tables->buffercount--;
+#endif /* PARSER_STATS */
+   }
+}
+
+
 static void enqueue_error
 (
    sdt_tables *tables,
@@ -244,7 +637,7 @@ static void enqueue_error
    {
 /*    Insert the first message in the queue */
 
-      dyncheck(&tables->msgqueue, MSGSIZE * 2);
+      dynringcheck(&tables->msgqueue, MSGCOUNT + 1);
 
       MSGQUEUE(MSGCOUNT  ).point   = *point;
       MSGQUEUE(MSGCOUNT  ).last    = *point;
@@ -279,12 +672,10 @@ static void enqueue_error
 
 /* Other errors are inserted in the correct position in the queue */
 
-   dyncheck(&tables->msgqueue, MSGSIZE * 2);
+   dynringcheck(&tables->msgqueue, MSGCOUNT + 1);
 
    for (i = MSGCOUNT; i > 0; i--)
-      if (MSGQUEUE(i - 1).point.buffer->order >  point->buffer->order ||
-	  MSGQUEUE(i - 1).point.buffer->order == point->buffer->order &&
-	  MSGQUEUE(i - 1).point.offset        >  point->offset)
+      if (POSITION(MSGQUEUE(i - 1).point) > POSITION(*point))
 	 MSGQUEUE(i) = MSGQUEUE(i - 1);
       else
 	 break;
@@ -318,9 +709,8 @@ static int error_value
 /*    Record a fatal syntax error and write the current line */
 
       record_error(tables, &TKNQUEUE(0).where, "Syntax error");
-      while (tables->unwritten.buffer->order < TKNQUEUE(0).locus.buffer->order ||
-	     tables->unwritten.buffer == TKNQUEUE(0).locus.buffer && tables->unwritten.offset <= TKNQUEUE(0).locus.offset)
-	 write_line(tables);
+      flush_lines(tables, &TKNQUEUE(0).where);
+      write_line(tables);
       exit(1);
    }
 
@@ -388,6 +778,7 @@ static int error_value
 
       INSERTION(INSCOUNT  ).token  = value;
       INSERTION(INSCOUNT  ).symbol = NULL;
+      INSERTION(INSCOUNT  ).length = 0;
       INSERTION(INSCOUNT  ).cost   = INSERTION(INSCOUNT - 1).cost + tables->inscost[value];
       INSERTION(INSCOUNT++).known  = false;
 
@@ -400,391 +791,728 @@ static int error_value
 }
 
 
-void free_parser
+static bool find_failure
 (
-   sdt_tables *tables
+   sdt_tables *tables,
+   int	       state,
+   long long   position
 )
 {
-   bufferentry *nextbuff;
-   nameentry   *nextname;
-   int		i;
+/* Returns true if the scanner has already reached this state at this */
+/* input position and gone on to fail without finding a final state   */
 
-/* We're done reading the file so we can close it */
+   unsigned int i;
 
-   close(tables->inputfd);
+   if (!tables->failtable || position > tables->failmax)
+      return(false);
 
-/* Free any leftover input buffers */
+   for (i = hash_failure(state, position) & (tables->failsize - 1); tables->failtable[i].state; i = (i + 1) & (tables->failsize - 1))
+      if (tables->failtable[i].state == state && tables->failtable[i].position == position)
+	 return(true);
+   return(false);
+}
 
-   while (tables->bufferlist)
-   {
-      nextbuff = tables->bufferlist->next;
-      free(tables->bufferlist);
-      tables->bufferlist = nextbuff;
-   }
-   tables->bufferlist = NULL;
-   tables->bufferend  = NULL;
 
-/* Free the scanner token tables */
+static int find_keyword
+(
+   sdt_tables *tables,
+   int	       token
+)
+{
+/* Look up the string of the token just scanned among the keywords for */
+/* which the scanner returns token, and return the keyword's slot in   */
+/* the perfect hash table or -1 if the string is not one of them       */
 
-   free(tables->tokenend);
-   tables->tokenend  = NULL;
-   free(tables->followset);
-   tables->followset = NULL;
+   keywordentry	 *keywords;		/* Keyword lookup table */
+   unsigned char *string;		/* Token string */
+   location	  where;		/* Current position in token */
+   int		  length;		/* Length of token string */
+   int		  slot;			/* Slot the token string hashes to */
 
-/* Free all the working buffers */
+   keywords = tables->keywords;
+   where    = TKNQUEUE(TKNCOUNT).where;
 
-   dynfree(&tables->chrstring);
-   for (i = 0; i < MSGCOUNT; i++)
-      free(MSGQUEUE(i).message);
-   dynfree(&tables->msgqueue);
-   for (i = 0; i < PARCOUNT; i++)
-      free(PARSTACK(i).symbol);
-   dynfree(&tables->parstack);
-   dynfree(&tables->redqueue);
-   for (i = 0; i < TKNCOUNT; i++)
-      free(TKNQUEUE(i).symbol);
-   dynfree(&tables->tknqueue);
-   dynfree(&tables->errstack);
-   dynfree(&tables->lclstack);
-   dynfree(&tables->stastack);
-   dynfree(&tables->chkqueue);
-   for (i = 0; i < SCNCOUNT; i++)
-      free(SCNSTACK(i).symbol);
-   dynfree(&tables->scnstack);
-   for (i = 0; i < DELCOUNT; i++)
-      free(DELETION(i).symbol);
-   dynfree(&tables->deletion);
-   for (i = 0; i < INSCOUNT; i++)
-      free(INSERTION(i).symbol);
-   dynfree(&tables->insertion);
+/* A token within a single buffer is looked up in place.  Otherwise	*/
+/* it is copied just past the end of any message being built, unless	*/
+/* it is too long to be a keyword					*/
 
-/* And free the symbol name to token number symbol table */
+   if (where.buffer == tables->position.buffer)
+   {
+      if ((length = tables->position.offset - where.offset) > keywords->maxlength)
+	 return(-1);
+      string = &where.buffer->buffer[where.offset];
+   }
+   else
+   {
+      while (CHRSIZE - CHRCOUNT < keywords->maxlength)
+	 dynresize(&tables->chrstring, CHRSIZE * 2);
+      string = (unsigned char *) &CHRSTRING(CHRCOUNT);
 
-   for (i = 0; i < HASH_TABLE_SIZE; i++)
-      while (tables->nametable[i])
-      {
-	 nextname = tables->nametable[i]->next;
-	 free(tables->nametable[i]->name);
-	 free(tables->nametable[i]);
-	 tables->nametable[i] = nextname;
-      }
+      for (length = 0; where.offset != tables->position.offset || where.buffer != tables->position.buffer; )
+	 if (where.offset >= where.buffer->count)
+	 {
+	    where.buffer = where.buffer->next;
+	    where.offset = 0;
+	 }
+	 else if (length == keywords->maxlength)
+	    return(-1);
+	 else
+	    string[length++] = where.buffer->buffer[where.offset++];
+   }
+
+/* Find the only slot the string could be in and check that it is there */
+
+   slot = hash_keyword(keywords->seed[hash_keyword(0, string, length) % keywords->buckets], string, length) % keywords->count;
+   if (keywords->base[slot] != token || keywords->nameindex[slot + 1] - keywords->nameindex[slot] != length)
+      return(-1);
+   if (keywords->fold[slot] ? strncasecmp(string, &keywords->nametable[keywords->nameindex[slot]], length)
+			    : memcmp(string, &keywords->nametable[keywords->nameindex[slot]], length))
+      return(-1);
+   return(slot);
 }
 
 
-void init_parser
+static bool find_newline
 (
    sdt_tables *tables,
-   int	       fd,
-   void	     (*action)(sdt_tables *, int),
-   void	     (*token)(sdt_tables *, tokenentry *)
+   location   *where,
+   location   *limit
 )
 {
-   int length;
-   int i;
+/* Advance where just past the next newline.  The search stops at limit, */
+/* or at end of file if limit is NULL.  Returns true if a newline was	 */
+/* found								 */
 
-   tables->inputfd = fd;
+   unsigned char *found;		/* Newline found in the buffer */
+   int		  end;			/* End of the search in this buffer */
 
-/* Save perform_action and install_token callbacks */
+   for (;;)
+   {
+      if (where->offset >= where->buffer->count && (!limit || where->buffer != limit->buffer) && !read_buffer(tables, where))
+	 return(false);
 
-   tables->action  = action;
-   tables->token   = token;
+      end = (limit && where->buffer == limit->buffer) ? limit->offset : where->buffer->count;
+      if (where->offset < end && (found = (unsigned char *) memchr(&where->buffer->buffer[where->offset], '\n', end - where->offset)))
+      {
+	 where->offset = found - where->buffer->buffer + 1;
+	 return(true);
+      }
+      where->offset = end;
 
-   tables->listing = false;
+      if (limit && where->buffer == limit->buffer)
+	 return(false);
+   }
+}
 
-/* Allocate initial input buffer */
 
-   if (tables->bufferlist = (bufferentry *) malloc(sizeof(*tables->bufferlist)))
-   {
-      tables->bufferlist->next  = NULL;
-      tables->bufferlist->order = 0;
-      tables->bufferlist->count = 0;
-      tables->bufferend         = tables->bufferlist;
-   }
-   else
-      out_of_memory();
+static void flush_cache
+(
+   sdt_tables *tables
+)
+{
+/* Discard every lazily built scanner state and build the start state */
 
-   tables->position.buffer = tables->bufferlist;
-   tables->position.offset = 0;
-   tables->newline         = true;
-   tables->endfile         = false;
-   tables->lineno          = 0;
+   cacheentry *cache;
+   nfaentry   *nfa;
 
-/* And record the current position in the buffer */
+   cache = tables->cache;
+   nfa   = tables->nfa;
 
-   tables->unwritten  = tables->position;
-   tables->msgwritten = false;
-   tables->beginning  = tables->position;
-
-   if (!(tables->tokenend  = (location *) malloc((tables->ntokens + 2) * sizeof(*tables->tokenend))) ||
-       !(tables->followset = (int *)      malloc((tables->tnumber + 1) * sizeof(*tables->followset))))
-      out_of_memory();
+   cache->count   = 1;
+   LAZYSETCOUNT   = 0;
+   LAZYTOKENCOUNT = 0;
+   memset(cache->bucket, 0, 2 * cache->size * sizeof(*cache->bucket));
 
-/* Allocate and initialize reallocatable arrays */
+   memcpy(cache->merge, &nfa->start[1], nfa->start[0] * sizeof(*cache->merge));
+   qsort(cache->merge, nfa->start[0], sizeof(*cache->merge), &compare_positions);
+   build_state(tables, nfa->start[0]);
+}
 
-   dynalloc(&tables->chrstring, sizeof(char), 80);
-   dynalloc(&tables->msgqueue, sizeof(errorentry), INITIAL_MSGQUEUE_SIZE);
-   dynalloc(&tables->parstack, sizeof(parseentry), INITIAL_PARSTACK_SIZE);
-   dynalloc(&tables->redqueue, sizeof(reduceentry), INITIAL_REDQUEUE_SIZE);
-   dynalloc(&tables->tknqueue, sizeof(tokenentry), INITIAL_TKNQUEUE_SIZE);
-   dynalloc(&tables->errstack, sizeof(int), INITIAL_ERRSTACK_SIZE);
-   dynalloc(&tables->lclstack, sizeof(int), INITIAL_LCLSTACK_SIZE);
-   dynalloc(&tables->stastack, sizeof(int), INITIAL_STASTACK_SIZE);
-   dynalloc(&tables->chkqueue, sizeof(int), INITIAL_CHKQUEUE_SIZE);
-   dynalloc(&tables->scnstack, sizeof(tokenentry), INITIAL_SCNSTACK_SIZE);
-   dynalloc(&tables->deletion, sizeof(tokenentry), INITIAL_DELETION_SIZE);
-   dynalloc(&tables->insertion, sizeof(insertentry), INITIAL_INSERTION_SIZE);
 
-/* Initialize map of symbol names to token numbers */
+static void flush_lines
+(
+   sdt_tables *tables,
+   location   *where
+)
+{
+/* Write or skip every line that ends before where, so that where is on */
+/* the first unwritten line.  Line ends are found lazily by searching	*/
+/* the input from lineend, which is never searched twice		*/
 
-   for (i = 0; i < HASH_TABLE_SIZE; i++)
-      tables->nametable[i] = NULL;
-   for (i = 1; i <= tables->tnumber; i++)
-   {
-      length = tables->stringindex[i + 1] - tables->stringindex[i];
+   int count;				/* Number of lines skipped */
+   int last;				/* Offset of the last line skipped */
+   int end;				/* End of the search in this buffer */
 
-/*    Double the size of the string array until it can hold the name */
+   if (POSITION(tables->lineend) < POSITION(tables->unwritten))
+      tables->lineend = tables->unwritten;
 
-      while (CHRSIZE < length + 1)
-	 dynresize(&tables->chrstring, CHRSIZE * 2);
+   if (!tables->listing && (!MSGCOUNT || POSITION(MSGQUEUE(0).point) >= POSITION(*where)))
+   {
+/*    None of these lines would be written, so just count their newlines */
 
-/*    Save the token name and number */
+      while (POSITION(tables->lineend) < POSITION(*where))
+      {
+	 if (tables->lineend.offset >= tables->lineend.buffer->count)
+	 {
+	    tables->lineend.buffer = tables->lineend.buffer->next;
+	    tables->lineend.offset = 0;
+	 }
 
-      snprintf(&CHRSTRING(0), CHRSIZE, "%.*s", length, &tables->stringtable[tables->stringindex[i]]);
-      lookup_token(tables, &CHRSTRING(0), TERMINAL, INSERT)->token = i;
-   }
-   for (i = tables->tnumber + 1; i <= tables->tnumber + tables->ntnumber; i++)
-   {
-      length = tables->stringindex[i + 1] - tables->stringindex[i];
-      while (CHRSIZE < length + 1)
-	 dynresize(&tables->chrstring, CHRSIZE * 2);
-      snprintf(&CHRSTRING(0), CHRSIZE, "%.*s", length, &tables->stringtable[tables->stringindex[i]]);
-      lookup_token(tables, &CHRSTRING(0), NONTERMINAL, INSERT)->token = i;
+	 end = (tables->lineend.buffer == where->buffer) ? where->offset : tables->lineend.buffer->count;
+	 if (count = count_lines(tables->lineend.buffer->buffer, tables->lineend.offset, end, &last))
+	 {
+	    tables->lineno           += count;
+	    tables->unwritten.buffer  = tables->lineend.buffer;
+	    tables->unwritten.offset  = last;
+	 }
+	 tables->lineend.offset = end;
+      }
+      drop_buffers(tables);
    }
+   else
+      while (POSITION(tables->lineend) < POSITION(*where) && find_newline(tables, &tables->lineend, where))
+	 write_line(tables);
 
-#ifdef	  PARSER_STATS
-   tables->buffercount  = 1;
-   tables->bufferrange  = tables->buffercount;
-   tables->messagerange = 0;
-   tables->parserange   = 0;
-   tables->reducerange  = 0;
-   tables->tokenrange   = 0;
-   tables->scanrange    = 0;
-   tables->deleterange  = 0;
-   tables->insertrange  = 0;
-#endif /* PARSER_STATS */
+/* A token at end of file also completes a last line with no newline */
+
+   if (POSITION(tables->unwritten) < POSITION(*where) &&
+       where->offset >= where->buffer->count && !where->buffer->next && tables->endfile)
+      write_line(tables);
 }
 
 
-static int input_char
+static void free_buffer
 (
-   sdt_tables *tables,
-   location   *where
+   bufferentry *buffer
 )
 {
-/* Get next character from the current input buffer */
+/* Unmap the piece of the input file this buffer maps, if any, then free */
+/* the buffer.  The data of a memory buffer belongs to the caller of	  */
+/* init_parser_buffer							  */
 
-   int ch;		/* Current input character */
+   if (buffer->type == MAPPED_BUFFER)
+      munmap(buffer->buffer, buffer->count);
+   free(buffer);
+}
 
-/* If there is no character at the current position  */
-/* and no further characters in the file, return EOF */
 
-   if (tables->position.offset >= tables->position.buffer->count && !read_buffer(tables, &tables->position))
-   {
-/*    End of file is hypothetically the start of the next line */
+static void free_cache
+(
+   sdt_tables *tables
+)
+{
+/* Free the lazily built scanner states, which the final state and  */
+/* install flag tables point into				    */
 
-      *where            = tables->position;
-      tables->beginning = tables->position;
-      return(ENDFILE);
-   }
+   cacheentry *cache;
 
-   *where = tables->position;
-   if (tables->newline)
+   if (cache = tables->cache)
    {
-      tables->beginning = tables->position;
-      tables->newline   = false;
+      free(cache->states);
+      free(cache->final);
+      free(cache->install);
+      free(cache->next);
+      free(cache->bucket);
+      free(cache->merge);
+      free(cache->mark);
+      dynfree(&cache->positions);
+      dynfree(&cache->tokens);
+      free(cache);
+      tables->cache   = NULL;
+      tables->final   = NULL;
+      tables->install = NULL;
    }
-
-/* If the current character is a newline the next character is the start of a new line */
-
-   if ((ch = tables->position.buffer->buffer[tables->position.offset++]) == '\n')
-      tables->newline = true;
-   return(ch);
 }
 
 
-static void input_token
+void free_parser
 (
    sdt_tables *tables
 )
 {
-/* Get the next token from the input file */
+   bufferentry	 *nextbuff;
+   nameentry	 *nextname;
+   readerentry	 *reader;
+   pipelineentry *pipeline;
+   parallelentry *parallel;
+   chunkentry	 *chunk;
+   sdt_tables	 *copy;
+   int		  i, j;
+
+/* Stop the read ahead thread, which may be waiting for input or for */
+/* room in the queue, and free the buffers still in its queues	     */
+
+   if (reader = tables->reader)
+   {
+      pthread_cancel(reader->thread);
+      pthread_join(reader->thread, NULL);
+
+      for (; !sem_trywait(&reader->fillcount); reader->fillhead = (reader->fillhead + 1) % reader->size)
+	 free_buffer(reader->filled[reader->fillhead]);
+      for (; !sem_trywait(&reader->sparecount); reader->sparehead = (reader->sparehead + 1) % reader->size)
+	 free_buffer(reader->spare[reader->sparehead]);
+
+      sem_destroy(&reader->fillcount);
+      sem_destroy(&reader->fillspace);
+      sem_destroy(&reader->sparecount);
+      sem_destroy(&reader->sparespace);
+      free(reader);
+      tables->reader = NULL;
+   }
 
-   int	    ch;				/* Current character in token */
-   int	    final;			/* Number of last final state */
-   int	    state;			/* Current scanner state number */
-   location where;			/* Current position in token */
-   int	    i;
+/* Stop the scanner thread, which may be waiting for room in its queue */
 
-/* Interpret the scanner tables to determine the next token */
+   if (pipeline = tables->pipeline)
+   {
+      pthread_cancel(pipeline->thread);
+      pthread_join(pipeline->thread, NULL);
+
+      sem_destroy(&pipeline->fillcount);
+      sem_destroy(&pipeline->fillspace);
+      free_scanner(pipeline->tables);
+      free(pipeline);
+      tables->pipeline = NULL;
+   }
 
-   dyncheck(&tables->tknqueue, TKNSIZE * 2);
+/* We're done reading the file so we can close it */
 
-   for (;;)
-   {
-/*    Record the start of line and the current position of the token */
+   if (tables->inputfd >= 0)
+      close(tables->inputfd);
 
-      ch = input_char(tables, &where);
-      TKNQUEUE(TKNCOUNT).locus = tables->beginning;
-      TKNQUEUE(TKNCOUNT).where = where;
+/* Free the scanner token tables */
 
-/*    Initialize the number of the last encountered final state */
+   free(tables->tokenend);
+   tables->tokenend  = NULL;
+   free(tables->followset);
+   tables->followset = NULL;
 
-      final = -1;
+/* Free all the working buffers */
 
-/*    Run through the finite-state automaton until no transition is possible */
+   dynfree(&tables->chrstring);
+   for (i = 0; i < MSGCOUNT; i++)
+      free(MSGQUEUE(i).message);
+   dynfree(&tables->msgqueue);
+   for (i = 0; i < PARCOUNT; i++)
+      free_symbol(tables, PARSTACK(i).symbol);
+   dynfree(&tables->parstack);
+   dynfree(&tables->redqueue);
+   dynfree(&tables->redstate);
+   for (i = 0; i < TKNCOUNT; i++)
+      free_symbol(tables, TKNQUEUE(i).symbol);
+   dynfree(&tables->tknqueue);
+   dynfree(&tables->errstack);
+   dynfree(&tables->lclstack);
+   dynfree(&tables->stastack);
+   dynfree(&tables->chkqueue);
+   for (i = 0; i < SCNCOUNT; i++)
+      free_symbol(tables, SCNSTACK(i).symbol);
+   dynfree(&tables->scnstack);
+   for (i = 0; i < DELCOUNT; i++)
+      free_symbol(tables, DELETION(i).symbol);
+   dynfree(&tables->deletion);
+   for (i = 0; i < INSCOUNT; i++)
+      free_symbol(tables, INSERTION(i).symbol);
+   dynfree(&tables->insertion);
+   dynfree(&tables->failpath);
+   free(tables->failtable);
+   tables->failtable = NULL;
 
-      state = 1;
-      do
-      {
-/*	 Record the end of token position for all tokens ending in this state */
+/* Free the lazily built scanner states */
 
-	 for (i = tables->tokenindex[state]; i < tables->tokenindex[state + 1]; i++)
-	    tables->tokenend[tables->tokentable[i]] = where;
+   free_cache(tables);
 
-/*	 Remember the last final state encountered */
+/* Free the copies of the scanner used by the scanning threads, which */
+/* are all stopped between calls to scan_tokens, along with the error */
+/* messages they found which have not yet been returned		      */
 
-	 if (tables->final[state])
-	    final = state;
+   if (parallel = tables->parallel)
+   {
+      for (i = 0; i < parallel->size; i++)
+      {
+	 chunk = &parallel->chunk[i];
+	 copy  = chunk->tables;
+	 for (j = chunk->message; j < DYNCOUNT(copy->msgqueue); j++)
+	    free(DYNRING(errorentry, copy->msgqueue, j).message);
 
-/*	 Search through the scanner default state chain until a valid transition is found */
+	 free_scanner(copy);
+	 dynfree(&chunk->spans);
+      }
+      free(parallel);
+      tables->parallel = NULL;
+   }
 
-	 while (tables->scheck[i = tables->sbase[state] + ch] != state && (state = tables->sdefault[state]))
-	    ;
+/* Free any leftover input buffers once no string slice refers to them */
 
-/*	 If a new state must be checked get the next input character */
+   while (tables->bufferlist)
+   {
+      nextbuff = tables->bufferlist->next;
+      free_buffer(tables->bufferlist);
+      tables->bufferlist = nextbuff;
+   }
+   tables->bufferlist = NULL;
+   tables->bufferend  = NULL;
 
-	 if (state && (state = tables->snext[i]))
-	    ch = input_char(tables, &where);
-      }
-      while (state);
+/* Along with the pool of buffers waiting to be reused */
 
-      if (final < 0)
-      {
-/*	 Since we have encountered no final state, record a lexical error, */
-/*	 skip a character in the input buffer, and look for a token again  */
+   while (tables->bufferpool)
+   {
+      nextbuff = tables->bufferpool->next;
+      free_buffer(tables->bufferpool);
+      tables->bufferpool = nextbuff;
+   }
 
-	 record_error(tables, &TKNQUEUE(TKNCOUNT).where, NULL);
+/* And free the symbol name to token number symbol table */
 
-	 tables->position = TKNQUEUE(TKNCOUNT).where;
-	 tables->position.offset++;
-      }
-      else
+   for (i = 0; i < HASH_TABLE_SIZE; i++)
+      while (tables->nametable[i])
       {
-/*	 Reset the position in the buffer to the end of the token encountered */
+	 nextname = tables->nametable[i]->next;
+	 free(tables->nametable[i]->name);
+	 free(tables->nametable[i]);
+	 tables->nametable[i] = nextname;
+      }
+}
 
-	 tables->position = tables->tokenend[tables->final[final]];
 
-/*	 If this is not an ignored token, we're done */
+static void free_scanner
+(
+   sdt_tables *tables
+)
+{
+/* Free a copy of the scanner data made for a scanning thread */
 
-	 if (tables->final[final] <= tables->tnumber)
-	    break;
-      }
-   }
+   free(tables->tokenend);
+   dynfree(&tables->chrstring);
+   dynfree(&tables->msgqueue);
+   dynfree(&tables->tknqueue);
+   dynfree(&tables->failpath);
+   free(tables->failtable);
+   free_cache(tables);
+   free(tables);
+}
 
-/* Put token value on token stack */
 
-   TKNQUEUE(TKNCOUNT).token = tables->final[final];
+static void free_symbol
+(
+   sdt_tables	 *tables,
+   unsigned char *symbol
+)
+{
+/* Free a token string unless it is a slice of a mapped or caller owned */
+/* input buffer, in which case the input itself holds the string	*/
 
-   if (tables->install[final])
-   {
-/*    Since the token install flag is set, record the token string along  */
-/*    with the token number on the stack, and invoke a procedure to check */
-/*    the token (and possibly change the token number determined by the   */
-/*    scanner).  It may also record the string in the symbol table, etc.  */
+   bufferentry *buffer;
 
-/*    First, determine the length of the token and allocate a buffer for it */
+   if (tables->slices)
+      for (buffer = tables->bufferlist; buffer && buffer->type != READ_BUFFER; buffer = buffer->next)
+	 if (symbol >= buffer->buffer && symbol <= &buffer->buffer[buffer->count])
+	    return;
+   free(symbol);
+}
 
-      i     = 0;
-      where = TKNQUEUE(TKNCOUNT).where;
-      if (where.buffer != tables->position.buffer)
-      {
-	 i += where.buffer->count - where.offset;
-	 where.buffer = where.buffer->next;
-	 where.offset = 0;
 
-	 while (where.buffer != tables->position.buffer)
-	 {
-	    i += where.buffer->count;
-	    where.buffer = where.buffer->next;
-	 }
-      }
-      i += tables->position.offset - where.offset;
+static void grow_cache
+(
+   sdt_tables *tables
+)
+{
+/* Double the number of scanner states the cache can hold and rehash  */
+/* the states already built into the larger hash table		      */
 
-/*    Now copy the token into a contiguous buffer */
+   cacheentry	*cache;
+   unsigned int	 bucket;
+   int		 i;
 
-      if (TKNQUEUE(TKNCOUNT).symbol = malloc(i + 1))
-      {
-	 i     = 0;
-	 where = TKNQUEUE(TKNCOUNT).where;
-	 while (where.offset != tables->position.offset || where.buffer != tables->position.buffer)
-	 {
-	    if (where.offset >= where.buffer->count)
-	    {
-	       where.buffer = where.buffer->next;
-	       where.offset = 0;
-	    }
+   cache        = tables->cache;
+   cache->size *= 2;
 
-	    TKNQUEUE(TKNCOUNT).symbol[i++] = where.buffer->buffer[where.offset++];
-	 }
-	 TKNQUEUE(TKNCOUNT).symbol[i] = '\0';
-      }
-      else
-	 out_of_memory();
+   if (!(cache->states  = (lazyentry *) realloc(cache->states, cache->size * sizeof(*cache->states))) ||
+       !(cache->final   = (int *)       realloc(cache->final, cache->size * sizeof(*cache->final))) ||
+       !(cache->install = (char *)      realloc(cache->install, cache->size * sizeof(*cache->install))) ||
+       !(cache->next    = (int *)       realloc(cache->next, cache->size * tables->nfa->classes * sizeof(*cache->next))) ||
+       !(cache->bucket  = (int *)       realloc(cache->bucket, 2 * cache->size * sizeof(*cache->bucket))))
+      out_of_memory();
 
-      (*tables->token)(tables, &TKNQUEUE(TKNCOUNT));
+   memset(cache->bucket, 0, 2 * cache->size * sizeof(*cache->bucket));
+   for (i = 1; i < cache->count; i++)
+   {
+      bucket                = hash_positions(&LAZYSET(cache->states[i].setindex), cache->states[i].setcount) & (2 * cache->size - 1);
+      cache->states[i].link = cache->bucket[bucket];
+      cache->bucket[bucket] = i;
    }
-   else
-      TKNQUEUE(TKNCOUNT).symbol = NULL;
 
-   TKNCOUNT++;
+   tables->final   = cache->final;
+   tables->install = cache->install;
 }
 
 
-static int look_ahead
+void init_parser
 (
    sdt_tables *tables,
-   int	       token,			/* Valid token to check, else 0 */
-   int	       count,			/* Number of continuation tokens */
-   int	       number			/* Number of input tokens to check */
+   int	       fd,
+   int	       size,
+   void	     (*action)(sdt_tables *, int),
+   void	     (*token)(sdt_tables *, tokenentry *)
 )
 {
-/* Parse ahead with a copy of the current parse stack and a token stack	 */
-/* consisting of the token "token" or by "count" tokens from the current */
-/* continuation string which are then followed by "number" tokens from	 */
-/* the input stream.  Return the number of tokens remaining when the	 */
-/* parser finds an error, or 0 if all the tokens are consumed without	 */
-/* a syntax error							 */
+/* Input that can't be mapped is read size bytes at a time */
 
-   int pointer;				/* Top of state stack */
+   tables->inputfd    = fd;
+   tables->buffersize = (size > 0) ? size : MAXBUFFER;
 
-   int action;				/* Type of parsing action */
-   int entry;				/* Next state/production number */
-   int i;				/* Temporaries */
+/* Map a regular file into buffers of at most MAXMAPPING bytes,	*/
+/* otherwise allocate the initial input buffer to be filled by	*/
+/* read_buffer as needed					*/
 
-/* Make a local copy of the states on the parse stack */
+   if (!map_input(tables))
+   {
+      tables->bufferlist = allocate_buffer(0, tables->buffersize);
+      tables->endfile    = false;
+   }
+   setup_parser(tables, action, token);
+}
 
-   memcpy(&STASTACK(0), &ERRSTACK(0), (STACOUNT = ERRCOUNT) * ERRELEMENT);
 
-/* If a special token is to be checked, put it onto the local token stack */
+void init_parser_buffer
+(
+   sdt_tables	 *tables,
+   unsigned char *data,
+   long long	  length,
+   void		(*action)(sdt_tables *, int),
+   void		(*token)(sdt_tables *, tokenentry *)
+)
+{
+/* Parse length bytes of caller owned memory.  The scanner walks the data */
+/* in place so it must not be changed or freed until free_parser is called */
 
-   if (CHKSIZE < (i = ((token > 0) ? 1 : 0) + count + number))
-      dynresize(&tables->chkqueue, i);
+   bufferentry *buffer;
+   long long	offset;
 
-   CHKCOUNT = 0;
-   if (token > 0)
-      CHKQUEUE(CHKCOUNT++) = token;
+   tables->inputfd    = -1;
+   tables->buffersize = 0;
 
-/* Otherwise copy "count" tokens from the continuation string onto the stack */
+/* Memory too large for an int buffer offset is split into several */
+/* buffers, just as a large mapped file is			   */
+
+   offset = 0;
+   do
+   {
+      buffer         = allocate_buffer(offset, 0);
+      buffer->count  = (length - offset < MAXMAPPING) ? length - offset : MAXMAPPING;
+      buffer->type   = MEMORY_BUFFER;
+      buffer->buffer = &data[offset];
+
+      if (offset)
+	 tables->bufferend->next = buffer;
+      else
+	 tables->bufferlist = buffer;
+      tables->bufferend = buffer;
+   }
+   while ((offset += buffer->count) < length);
+
+   tables->endfile = true;
+   setup_parser(tables, action, token);
+}
+
+
+static unsigned int hash_failure
+(
+   int	     state,
+   long long position
+)
+{
+/* Hash a scanner state and input position into the failure table */
+
+   unsigned long long hash;
+
+   hash = ((unsigned long long) position * 31 + state) * 0x9E3779B97F4A7C15ULL;
+   return((unsigned int) (hash >> 32));
+}
+
+
+static unsigned int hash_positions
+(
+   int *positions,
+   int	count
+)
+{
+/* Hash a sorted set of NFA positions into the scanner state cache */
+
+   unsigned int hash;
+   int		i;
+
+   for (hash = count, i = 0; i < count; i++)
+      hash = (hash ^ positions[i]) * 16777619;
+   return(hash ^ hash >> 16);
+}
+
+
+static int input_char
+(
+   sdt_tables *tables,
+   location   *where
+)
+{
+/* Get next character from the current input buffer */
+
+   int ch;		/* Current input character */
+
+/* If there is no character at the current position  */
+/* and no further characters in the file, return EOF */
+
+   if (tables->position.offset >= tables->position.buffer->count && !read_buffer(tables, &tables->position))
+   {
+      *where = tables->position;
+      return(ENDFILE);
+   }
+
+   *where = tables->position;
+   ch     = tables->position.buffer->buffer[tables->position.offset++];
+   return(ch);
+}
+
+
+static void input_token
+(
+   sdt_tables *tables
+)
+{
+/* Get the next token from the input file */
+
+   location where;			/* Current position in token */
+   location end;			/* End of the token */
+   char	    install;			/* True if the token string is recorded */
+   int	    i;
+
+/* Put token value on token stack, taking it from the scanner thread if */
+/* there is one								*/
+
+   if (tables->pipeline)
+      TKNQUEUE(TKNCOUNT).token = receive_token(tables, &install, &end);
+   else
+   {
+      TKNQUEUE(TKNCOUNT).token = scan_token(tables, &install);
+      end = tables->position;
+   }
+
+   if (install)
+   {
+/*    Since the token install flag is set, record the token string along  */
+/*    with the token number on the stack, and invoke a procedure to check */
+/*    the token (and possibly change the token number determined by the   */
+/*    scanner).  It may also record the string in the symbol table, etc.  */
+
+/*    First, determine the length of the token */
+
+      i     = 0;
+      where = TKNQUEUE(TKNCOUNT).where;
+      if (where.buffer != end.buffer)
+      {
+	 i += where.buffer->count - where.offset;
+	 where.buffer = where.buffer->next;
+	 where.offset = 0;
+
+	 while (where.buffer != end.buffer)
+	 {
+	    i += where.buffer->count;
+	    where.buffer = where.buffer->next;
+	 }
+      }
+      i += end.offset - where.offset;
+
+      TKNQUEUE(TKNCOUNT).length = i;
+
+/*    If string slices were requested and the token lies within a single */
+/*    mapped or caller owned buffer, which stays in memory until	  */
+/*    free_parser, the token string is simply a view into the input	  */
+
+      where = TKNQUEUE(TKNCOUNT).where;
+      if (tables->slices && where.buffer == end.buffer && where.buffer->type != READ_BUFFER)
+	 TKNQUEUE(TKNCOUNT).symbol = &where.buffer->buffer[where.offset];
+
+/*    Otherwise copy the token into a contiguous buffer */
+
+      else if (TKNQUEUE(TKNCOUNT).symbol = malloc(i + 1))
+      {
+	 i = 0;
+	 while (where.offset != end.offset || where.buffer != end.buffer)
+	 {
+	    if (where.offset >= where.buffer->count)
+	    {
+	       where.buffer = where.buffer->next;
+	       where.offset = 0;
+	    }
+	    else
+	       TKNQUEUE(TKNCOUNT).symbol[i++] = where.buffer->buffer[where.offset++];
+	 }
+	 TKNQUEUE(TKNCOUNT).symbol[i] = '\0';
+      }
+      else
+	 out_of_memory();
+
+      (*tables->token)(tables, &TKNQUEUE(TKNCOUNT));
+   }
+   else
+   {
+      TKNQUEUE(TKNCOUNT).symbol = NULL;
+      TKNQUEUE(TKNCOUNT).length = 0;
+   }
+
+   TKNCOUNT++;
+}
+
+
+static void locate_position
+(
+   location  *where,
+   long long  position
+)
+{
+/* Move where forward to the given input offset, which must not precede */
+/* it.  Just as input_char would, a location at the end of a buffer is	*/
+/* left at the start of the next buffer					*/
+
+   while (position >= where->buffer->start + where->buffer->count && where->buffer->next)
+      where->buffer = where->buffer->next;
+   where->offset = position - where->buffer->start;
+}
+
+
+static int look_ahead
+(
+   sdt_tables *tables,
+   int	       token,			/* Valid token to check, else 0 */
+   int	       count,			/* Number of continuation tokens */
+   int	       number			/* Number of input tokens to check */
+)
+{
+/* Parse ahead with a copy of the current parse stack and a token stack	 */
+/* consisting of the token "token" or by "count" tokens from the current */
+/* continuation string which are then followed by "number" tokens from	 */
+/* the input stream.  Return the number of tokens remaining when the	 */
+/* parser finds an error, or 0 if all the tokens are consumed without	 */
+/* a syntax error							 */
+
+   int pointer;				/* Top of state stack */
+
+   int action;				/* Type of parsing action */
+   int entry;				/* Next state/production number */
+   int i;				/* Temporaries */
+
+/* Make a local copy of the states on the parse stack */
+
+   memcpy(&STASTACK(0), &ERRSTACK(0), (STACOUNT = ERRCOUNT) * ERRELEMENT);
+
+/* If a special token is to be checked, put it onto the local token stack */
+
+   if (CHKSIZE < (i = ((token > 0) ? 1 : 0) + count + number))
+      dynresize(&tables->chkqueue, i);
+
+   CHKCOUNT = 0;
+   if (token > 0)
+      CHKQUEUE(CHKCOUNT++) = token;
+
+/* Otherwise copy "count" tokens from the continuation string onto the stack */
 
    for (i = 1; i <= count; i++)
       CHKQUEUE(CHKCOUNT++) = INSERTION(i).token;
@@ -875,6 +1603,77 @@ nameentry *lookup_token
 }
 
 
+static bool map_input
+(
+   sdt_tables *tables
+)
+{
+/* If the input is a regular file which has not been read from, map the */
+/* entire file into memory.  Pipes, sockets, and terminals are read by	*/
+/* read_buffer								*/
+
+   struct stat	  status;
+   unsigned char *data;
+   bufferentry	 *buffer;
+   long long	  offset;
+
+   if (fstat(tables->inputfd, &status) || !S_ISREG(status.st_mode) ||
+       status.st_size <= 0 || lseek(tables->inputfd, 0, SEEK_CUR) != 0)
+      return(false);
+
+   if ((data = (unsigned char *) mmap(NULL, status.st_size, PROT_READ, MAP_PRIVATE, tables->inputfd, 0)) == MAP_FAILED)
+      return(false);
+   madvise(data, status.st_size, MADV_SEQUENTIAL);
+
+/* The whole file is mapped so there is nothing left to read.  A file */
+/* too large for an int buffer offset is split into several buffers   */
+
+   for (offset = 0; offset < status.st_size; offset += buffer->count)
+   {
+      buffer         = allocate_buffer(offset, 0);
+      buffer->count  = (status.st_size - offset < MAXMAPPING) ? status.st_size - offset : MAXMAPPING;
+      buffer->type   = MAPPED_BUFFER;
+      buffer->buffer = &data[offset];
+
+      if (offset)
+	 tables->bufferend->next = buffer;
+      else
+	 tables->bufferlist = buffer;
+      tables->bufferend = buffer;
+   }
+   tables->endfile = true;
+   return(true);
+}
+
+
+static void move_messages
+(
+   sdt_tables *tables,
+   chunkentry *chunk,
+   long long   position
+)
+{
+/* Move the error messages a scanning thread found before position onto */
+/* the end of the queue.  The scanner only reports errors in order, and */
+/* never at the start of a token, so none is adjacent to a message	*/
+/* already queued							*/
+
+   dynarray *queue;			/* Messages found by the thread */
+
+   queue = &chunk->tables->msgqueue;
+   for (; chunk->message < DYNCOUNT(*queue) && POSITION(DYNRING(errorentry, *queue, chunk->message).point) < position; chunk->message++)
+   {
+      dynringcheck(&tables->msgqueue, MSGCOUNT + 1);
+      MSGQUEUE(MSGCOUNT++) = DYNRING(errorentry, *queue, chunk->message);
+
+#ifdef	  PARSER_STATS
+      if (MSGCOUNT > tables->messagerange)
+	 tables->messagerange = MSGCOUNT;
+#endif /* PARSER_STATS */
+   }
+}
+
+
 void parse_input
 (
    sdt_tables *tables
@@ -894,7 +1693,14 @@ void parse_input
    PARSTACK(PARCOUNT  ).where.buffer = NULL;
    PARSTACK(PARCOUNT  ).where.offset = 0;
    PARSTACK(PARCOUNT  ).token        = 0;
-   PARSTACK(PARCOUNT++).symbol       = NULL;
+   PARSTACK(PARCOUNT  ).symbol       = NULL;
+   PARSTACK(PARCOUNT++).length       = 0;
+
+/* Run the scanner in a thread of its own if that was requested and */
+/* the whole input is already in memory				    */
+
+   if (tables->scanahead > 0 && tables->endfile)
+      start_pipeline(tables);
 
 /* Current state and top of parse stack unaffected by postponed reduces */
 
@@ -931,6 +1737,7 @@ void parse_input
 	    PARSTACK(pointer).where  = TKNQUEUE(0).where;
 	    PARSTACK(pointer).token  = TKNQUEUE(0).token;
 	    PARSTACK(pointer).symbol = TKNQUEUE(0).symbol;
+	    PARSTACK(pointer).length = TKNQUEUE(0).length;
 	    PARCOUNT++;
 
 #ifdef	  PARSER_STATS
@@ -938,14 +1745,16 @@ void parse_input
 	       tables->parserange = PARCOUNT;
 #endif /* PARSER_STATS */
 
-/*	    Since we are shifting a terminal, all lines up to the current are complete */
+/*	    Since we are shifting a terminal, all lines up to the current are	*/
+/*	    complete.  Without a listing or an error they need only be counted */
 
-	    while (tables->unwritten.buffer->order < TKNQUEUE(0).locus.buffer->order ||
-		   tables->unwritten.buffer == TKNQUEUE(0).locus.buffer && tables->unwritten.offset < TKNQUEUE(0).locus.offset)
-	       write_line(tables);
+	    if (tables->listing || MSGCOUNT)
+	       flush_lines(tables, &TKNQUEUE(0).where);
+	    else
+	       if (tables->lineend.buffer != TKNQUEUE(0).where.buffer)
+		  discard_lines(tables, &TKNQUEUE(0).where);
 
-	    if (--TKNCOUNT)
-	       memmove(&TKNQUEUE(0), &TKNQUEUE(1), TKNCOUNT * TKNELEMENT);
+	    dynrotate(&tables->tknqueue, 1);
 
 	    if (action == SHIFT)
 	       break;
@@ -969,18 +1778,14 @@ void parse_input
 		  knownptr = pointer;
 
 	       if (pointer > knownptr)
-	       {
-/*		  We are within the part of the parse stack that has been affected by  */
-/*		  delayed reduces.  Search the reduce queue for the most recent reduce */
-/*		  that popped the stack to the current position.  If one is found, it  */
-/*		  will indicate the new state number.  If one is not found, then this  */
-/*		  is a reduction of the type <LHS> --> "", and the state is unchanged. */
-
-		  for (i = REDCOUNT - 1; i >= 0 && REDQUEUE(i).pointer > pointer; i--)
-		     ;
-		  if (REDQUEUE(i).pointer == pointer)
-		     state = REDQUEUE(i).state;
-	       }
+
+/*		  We are within the part of the parse stack that has been affected by	*/
+/*		  delayed reduces.  The most recent reduce that popped the stack to the	*/
+/*		  current position left its new state in the shadow state array.  Each	*/
+/*		  queued reduce leaves the stack at most one entry above the previous	*/
+/*		  one, so the entry for this position always belongs to the queue	*/
+
+		  state = REDSTATE(pointer);
 	       else
 
 /*		  We are in the part of the stack that is unaffected by delayed reduces  */
@@ -995,11 +1800,16 @@ void parse_input
 	       else
 		  state = 0;
 
-/*	       Save the reduce entry for the next shift of a token */
+/*	       Save the reduce entry for the next shift of a token, and the state */
+/*	       it leaves at this position for later reduces that pop back to it	  */
 
 	       REDQUEUE(REDCOUNT  ).pointer = ++pointer;
 	       REDQUEUE(REDCOUNT++).state   = state;
 
+	       if (pointer >= REDSTATESIZE)
+		  dynresize(&tables->redstate, pointer * 2);
+	       REDSTATE(pointer) = state;
+
 #ifdef	  PARSER_STATS
 	       if (REDCOUNT > tables->reducerange)
 		  tables->reducerange = REDCOUNT;
@@ -1038,6 +1848,81 @@ void parse_input
 }
 
 
+static int next_state
+(
+   sdt_tables *tables,
+   int	       state,
+   int	       ch			/* Input character class */
+)
+{
+/* Build the transition from a lazily built scanner state on an input  */
+/* character class by merging the follow sets of its positions which   */
+/* transition on that class.  Returns -1 if there is no transition     */
+
+   cacheentry *cache;			/* Scanner states built so far */
+   nfaentry   *nfa;			/* Scanner NFA */
+   int	       stride;			/* Bytes in each position's class bitmap */
+   int	       position;		/* NFA position in the state */
+   int	       follow;			/* NFA position which follows it */
+   int	       count;			/* Number of positions merged */
+   int	       i, j;
+
+   cache  = tables->cache;
+   nfa    = tables->nfa;
+   stride = (nfa->classes + 7) / 8;
+
+/* A new stamp marks the positions already merged for this transition */
+
+   if (++cache->stamp <= 0)
+   {
+      memset(cache->mark, 0, (nfa->positions + 1) * sizeof(*cache->mark));
+      cache->stamp = 1;
+   }
+
+   for (count = i = 0; i < cache->states[state].setcount; i++)
+   {
+      position = LAZYSET(cache->states[state].setindex + i);
+      if (nfa->classbits[position * stride + ch / 8] & 1 << ch % 8)
+	 for (j = nfa->followindex[position]; j < nfa->followindex[position + 1]; j++)
+	    if (cache->mark[follow = nfa->followtable[j]] != cache->stamp)
+	    {
+	       cache->mark[follow]   = cache->stamp;
+	       cache->merge[count++] = follow;
+	    }
+   }
+   if (!count)
+      return(-1);
+
+   qsort(cache->merge, count, sizeof(*cache->merge), &compare_positions);
+   return(build_state(tables, count));
+}
+
+
+static void pass_token
+(
+   pipelineentry *pipeline,
+   int		  token,
+   char		  install,
+   location	 *where,
+   location	 *end
+)
+{
+/* Wait for a free entry and hand a token or lexical error to the parser */
+
+   scannedentry *entry;
+
+   while (sem_wait(&pipeline->fillspace) && errno == EINTR)
+      ;
+   entry          = &pipeline->queue[pipeline->tail];
+   entry->token   = token;
+   entry->install = install;
+   entry->where   = *where;
+   entry->end     = *end;
+   pipeline->tail = (pipeline->tail + 1) % pipeline->size;
+   sem_post(&pipeline->fillcount);
+}
+
+
 static void perform_reduces
 (
    sdt_tables *tables,
@@ -1056,7 +1941,7 @@ static void perform_reduces
 /*    Remove the right hand side from the parse stack */
 
       while (PARCOUNT > REDQUEUE(i).pointer)
-	 free(PARSTACK(--PARCOUNT).symbol);
+	 free_symbol(tables, PARSTACK(--PARCOUNT).symbol);
 
 /*    And push the left hand side symbol */
 
@@ -1065,451 +1950,1653 @@ static void perform_reduces
       PARSTACK(PARCOUNT  ).state  = REDQUEUE(i).state;
       PARSTACK(PARCOUNT  ).where  = *where;
       PARSTACK(PARCOUNT  ).token  = tables->lhsymbol[REDQUEUE(i).number];
-      PARSTACK(PARCOUNT++).symbol = NULL;
+      PARSTACK(PARCOUNT  ).symbol = NULL;
+      PARSTACK(PARCOUNT++).length = 0;
 
 #ifdef	  PARSER_STATS
       if (PARCOUNT > tables->parserange)
 	 tables->parserange = PARCOUNT;
 #endif /* PARSER_STATS */
    }
-   REDCOUNT = 0;
+   REDCOUNT = 0;
+}
+
+
+static void *read_ahead
+(
+   void *argument
+)
+{
+/* Fill input buffers from the file and queue them for the scanner. */
+/* A buffer with no data in it marks the end of the file	    */
+
+   sdt_tables  *tables;		/* Tables of the parser being read for */
+   readerentry *reader;		/* Queues shared with the scanner */
+   bufferentry *buffer;		/* Buffer currently being filled */
+   int		count;
+
+   tables = (sdt_tables *) argument;
+   reader = tables->reader;
+   buffer = NULL;
+   pthread_cleanup_push(&discard_buffer, &buffer);
+
+   do
+   {
+/*    Reuse a buffer released by the scanner if there is one */
+
+      if (!sem_trywait(&reader->sparecount))
+      {
+	 buffer = reader->spare[reader->sparehead];
+	 reader->sparehead = (reader->sparehead + 1) % reader->size;
+	 sem_post(&reader->sparespace);
+      }
+      else
+	 buffer = allocate_buffer(0, tables->buffersize);
+
+/*    Fill the buffer unless the end of the file comes first */
+
+      while (buffer->count < tables->buffersize)
+      {
+	 if ((count = read(tables->inputfd, &buffer->buffer[buffer->count], tables->buffersize - buffer->count)) < 0)
+	 {
+	    perror("error reading input file");
+	    exit(1);
+	 }
+	 if (!count)
+	    break;
+	 buffer->count += count;
+      }
+      count = buffer->count;
+
+/*    Wait for a free slot and hand the buffer to the scanner */
+
+      while (sem_wait(&reader->fillspace) && errno == EINTR)
+	 ;
+      reader->filled[reader->filltail] = buffer;
+      reader->filltail = (reader->filltail + 1) % reader->size;
+      buffer = NULL;
+      sem_post(&reader->fillcount);
+   }
+   while (count);
+
+   pthread_cleanup_pop(0);
+   return(NULL);
+}
+
+
+static bool read_buffer
+(
+   sdt_tables *tables,
+   location   *where
+)
+{
+/* Read more data into buffer chain.  Returns true if another character is available */
+
+   int count;
+
+   if (where->buffer->next)
+   {
+      where->buffer = where->buffer->next;
+      where->offset = 0;
+   }
+   else
+      if (!tables->endfile)
+      {
+	 if (tables->readahead > 0)
+	 {
+	    receive_buffer(tables, where);
+	    return(where->offset < where->buffer->count);
+	 }
+
+	 if (where->buffer->count >= tables->buffersize)
+	 {
+	    where->buffer = acquire_buffer(tables, tables->bufferend->start + tables->bufferend->count);
+
+	    tables->bufferend->next = where->buffer;
+	    tables->bufferend       = where->buffer;
+
+#ifdef	  PARSER_STATS
+	    if (++tables->buffercount > tables->bufferrange)
+	       tables->bufferrange = tables->buffercount;
+#endif /* PARSER_STATS */
+
+	    where->offset = 0;
+	 }
+
+/*       Read data into buffer at end of array */
+
+	 if ((count = read(tables->inputfd, &tables->bufferend->buffer[tables->bufferend->count], tables->buffersize - tables->bufferend->count)) < 0)
+	 {
+	    perror("error reading input file");
+	    exit(1);
+	 }
+
+	 if (count)
+	    tables->bufferend->count += count;
+	 else
+	    tables->endfile = true;
+      }
+   return(where->offset < where->buffer->count);
+}
+
+
+static void receive_buffer
+(
+   sdt_tables *tables,
+   location   *where
+)
+{
+/* Append the next buffer filled by the read ahead thread to the buffer chain */
+
+   readerentry *reader;
+   bufferentry *buffer;
+
+   if (!tables->reader)
+      start_reader(tables);
+   reader = tables->reader;
+
+   while (sem_wait(&reader->fillcount) && errno == EINTR)
+      ;
+   buffer = reader->filled[reader->fillhead];
+   reader->fillhead = (reader->fillhead + 1) % reader->size;
+   sem_post(&reader->fillspace);
+
+/* An empty buffer means the thread has reached end of file */
+
+   if (!buffer->count)
+   {
+      tables->endfile = true;
+      release_buffer(tables, buffer);
+   }
+
+/* The initial buffer allocated by init_parser is still empty, so */
+/* copy the data into it rather than leave an empty buffer in the */
+/* chain								  */
+
+   else if (!tables->bufferend->count)
+   {
+      memcpy(tables->bufferend->buffer, buffer->buffer, buffer->count);
+      tables->bufferend->count = buffer->count;
+      release_buffer(tables, buffer);
+   }
+   else
+   {
+      buffer->start = tables->bufferend->start + tables->bufferend->count;
+
+      tables->bufferend->next = buffer;
+      tables->bufferend       = buffer;
+
+#ifdef	  PARSER_STATS
+      if (++tables->buffercount > tables->bufferrange)
+	 tables->bufferrange = tables->buffercount;
+#endif /* PARSER_STATS */
+
+      where->buffer = buffer;
+      where->offset = 0;
+   }
+}
+
+
+static int receive_token
+(
+   sdt_tables *tables,
+   char	      *install,
+   location   *end
+)
+{
+/* Take the next token found by the scanner thread, first moving the	*/
+/* lexical errors it found ahead of the token onto the end of the error	*/
+/* queue.  Every message already queued is at or before the last token	*/
+/* taken, so none belongs after these.  Once the end of file token has	*/
+/* been taken it is returned again on every call			*/
+
+   pipelineentry *pipeline;
+   scannedentry	  entry;
+
+   dynringcheck(&tables->tknqueue, TKNCOUNT + 1);
+
+   pipeline = tables->pipeline;
+   while (!pipeline->endfile)
+   {
+      while (sem_wait(&pipeline->fillcount) && errno == EINTR)
+	 ;
+      entry = pipeline->queue[pipeline->head];
+      pipeline->head = (pipeline->head + 1) % pipeline->size;
+      sem_post(&pipeline->fillspace);
+
+      if (entry.token)
+      {
+	 pipeline->endfile = (entry.token == tables->tnumber);
+	 pipeline->last    = entry;
+	 break;
+      }
+
+      dynringcheck(&tables->msgqueue, MSGCOUNT + 1);
+
+      MSGQUEUE(MSGCOUNT  ).point   = entry.where;
+      MSGQUEUE(MSGCOUNT  ).last    = entry.end;
+      MSGQUEUE(MSGCOUNT++).message = NULL;
+
+#ifdef	  PARSER_STATS
+      if (MSGCOUNT > tables->messagerange)
+	 tables->messagerange = MSGCOUNT;
+#endif /* PARSER_STATS */
+   }
+
+   TKNQUEUE(TKNCOUNT).where = pipeline->last.where;
+   *install = pipeline->last.install;
+   *end     = pipeline->last.end;
+   return(pipeline->last.token);
+}
+
+
+void record_error
+(
+   sdt_tables *tables,
+   location   *point,
+   char	      *fmt,
+   ...
+)
+{
+/* Format syntax/semantic error and enqueue it */
+
+   va_list args;
+
+   if (fmt)
+   {
+/*    Try to format the error message into a string */
+
+      va_start(args, fmt);
+      CHRCOUNT = vsnprintf(&CHRSTRING(0), CHRSIZE, fmt, args);
+      va_end(args);
+      if (CHRCOUNT < 0)
+      {
+	 fprintf(stderr, "error encountered while recording message \"%s\" (glibc < 2.0.6?)\n", fmt);
+	 exit(1);
+      }
+
+      if (CHRCOUNT >= CHRSIZE)
+      {
+/*	 Increase the string length to accomodate the error message */
+
+	 dynresize(&tables->chrstring, CHRCOUNT + 1);
+
+	 va_start(args, fmt);
+	 CHRCOUNT = vsnprintf(&CHRSTRING(0), CHRSIZE, fmt, args);
+	 va_end(args);
+      }
+
+      enqueue_error(tables, point, &CHRSTRING(0));
+   }
+   else
+
+/*    This is an undefined character encountered by the scanner */
+
+      enqueue_error(tables, point, NULL);
+}
+
+
+static void record_failures
+(
+   sdt_tables *tables,
+   long long   start
+)
+{
+/* None of the scanner states passed since the last final state led to */
+/* another final state, so remember them all as failures.  Entries for */
+/* positions before start, the beginning of the current token, can no  */
+/* longer be looked up, so the table is rebuilt without them whenever  */
+/* it becomes half full						       */
+
+   failentry *oldtable;			/* Failure table being rebuilt */
+   int	      oldsize;			/* Size of the old failure table */
+   int	      count;			/* Number of entries still needed */
+   int	      i;
+
+   if (tables->failused + FAILCOUNT > tables->failsize / 2)
+   {
+      count = FAILCOUNT;
+      for (i = 0; i < tables->failsize; i++)
+	 if (tables->failtable[i].state && tables->failtable[i].position >= start)
+	    count++;
+
+      oldtable = tables->failtable;
+      oldsize  = tables->failsize;
+
+      for (tables->failsize = INITIAL_FAILTABLE_SIZE; tables->failsize < count * 4; tables->failsize *= 2)
+	 ;
+      if (!(tables->failtable = (failentry *) calloc(tables->failsize, sizeof(*tables->failtable))))
+	 out_of_memory();
+      tables->failused = 0;
+
+      for (i = 0; i < oldsize; i++)
+	 if (oldtable[i].state && oldtable[i].position >= start)
+	    store_failure(tables, &oldtable[i], start);
+      free(oldtable);
+   }
+
+   for (i = 0; i < FAILCOUNT; i++)
+   {
+      store_failure(tables, &FAILPATH(i), start);
+      if (FAILPATH(i).position > tables->failmax)
+	 tables->failmax = FAILPATH(i).position;
+   }
+   FAILCOUNT = 0;
+}
+
+
+static void record_repair
+(
+   sdt_tables *tables,
+   int	       insert
+)
+{
+/* Report error repair as one or more syntax errors */
+
+   location where;
+   location scan;		/* Search for a newline between deleted tokens */
+   int	    token;
+   char	   *msg;
+   int	    i, j;
+
+   i = 0;
+   while (i < DELCOUNT)
+   {
+      where = DELETION(i).where;
+
+/*    If there is no insertion or the deleted tokens are  */
+/*    on multiple lines, report this line as deletions    */
+/*    only.  If there is an insertion and all the deleted */
+/*    tokens are on one line report it as a replacement   */
+
+      for (j = i + 1; j < DELCOUNT; j++)
+      {
+	 scan = DELETION(j - 1).where;
+	 if (find_newline(tables, &scan, &DELETION(j).where))
+	    break;
+      }
+
+      CHRCOUNT = 0;
+      append_message(tables, "%s", (j < DELCOUNT || !insert) ? "Deleted:" : "Replaced:");
+
+      while (i < j)
+	 if (!DELETION(i).symbol)
+	 {
+	    token = DELETION(i++).token;
+	    append_message(tables, " %.*s", tables->stringindex[token + 1] - tables->stringindex[token], &tables->stringtable[tables->stringindex[token]]);
+	 }
+	 else
+	 {
+	    append_message(tables, " %.*s", DELETION(i).length, DELETION(i).symbol);
+	    i++;
+	 }
+
+/*    If this message is complete, record it */
+
+      if (i < DELCOUNT || !insert)
+      {
+	 msg = strdup(&CHRSTRING(0));
+	 record_error(tables, &where, "%s", msg);
+	 free(msg);
+      }
+   }
+
+/* If tokens are being inserted display them as a replacement or insertion */
+
+   if (insert)
+   {
+      if (!DELCOUNT)
+      {
+/*	 If there are no deleted tokens we start an insertion message */
+
+	 where = TKNQUEUE(0).where;
+
+	 CHRCOUNT = 0;
+	 append_message(tables, "%s", "Inserted:");
+      }
+      else
+      {
+/*	 Otherwise we append the inserted tokens to the existing replacement message */
+
+	 append_message(tables, "%s", "  with ");
+
+/*	 If any of the tokens being inserted are the same as tokens that were */
+/*	 deleted, move the deleted symbol's value to the insertion string     */
+
+	 for (i = 1; i <= insert; i++)
+	 {
+/*	    Search the deleted tokens for the same token value with a symbol */
+
+	    for (j = 0; j < DELCOUNT; j++)
+	       if (DELETION(j).token == INSERTION(i).token && DELETION(j).symbol)
+	       {
+		  INSERTION(i).symbol = DELETION(j).symbol;
+		  INSERTION(i).length = DELETION(j).length;
+		  DELETION(j).symbol  = NULL;
+		  break;
+	       }
+	 }
+      }
+
+/*    Append the inserted tokens */
+
+      for (i = 1; i <= insert; i++)
+	 if (!INSERTION(i).symbol)
+	 {
+	    token = INSERTION(i).token;
+	    append_message(tables, " %.*s", tables->stringindex[token + 1] - tables->stringindex[token], &tables->stringtable[tables->stringindex[token]]);
+	 }
+	 else
+	    append_message(tables, " %.*s", INSERTION(i).length, INSERTION(i).symbol);
+
+/*    And record the completed error message */
+
+      msg = strdup(&CHRSTRING(0));
+      record_error(tables, &where, "%s", msg);
+      free(msg);
+   }
+}
+
+
+static void release_buffer
+(
+   sdt_tables  *tables,
+   bufferentry *buffer
+)
+{
+/* Keep a buffer filled by read_buffer for reuse, otherwise free it. */
+/* Buffers are returned to the read ahead thread while it has room   */
+
+   if (buffer->type != READ_BUFFER)
+      free_buffer(buffer);
+   else
+   {
+      buffer->next  = NULL;
+      buffer->count = 0;
+
+      if (tables->reader && !sem_trywait(&tables->reader->sparespace))
+      {
+	 tables->reader->spare[tables->reader->sparetail] = buffer;
+	 tables->reader->sparetail = (tables->reader->sparetail + 1) % tables->reader->size;
+	 sem_post(&tables->reader->sparecount);
+      }
+      else
+      {
+	 buffer->next       = tables->bufferpool;
+	 tables->bufferpool = buffer;
+      }
+   }
+}
+
+
+static void repair_error
+(
+   sdt_tables *tables
+)
+{
+/* Determine the locally least-cost error repair for this syntax error */
+
+   errorrepair choice;			/* Least cost repair (insert or prefix) */
+   errorrepair insert;			/* Valid token insertion repair */
+   errorrepair prefix;			/* Continuation prefix insertion repair */
+   int	       delete;			/* Total cost of deleted tokens */
+   int	       token;			/* Current token being checked */
+   int	       cost;			/* Cost of current correction */
+   int	       i;
+
+/* Make a local copy of the states on the parse stack */
+
+   if (ERRSIZE < PARSIZE)
+      dynresize(&tables->errstack, PARSIZE);
+   for (i = 0; i < PARCOUNT; i++)
+      ERRSTACK(i) = PARSTACK(i).state;
+   ERRCOUNT = PARCOUNT;
+
+/* Because of shiftreduce actions, the state on the top of the parse stack */
+/* may not be real.  Perform queued reduce actions until the parser is in  */
+/* a real state.  Because shiftreduce actions have no corresponding state  */
+/* applying them has no impact on future error repair quality.		   */
+
+   for (i = 0; !ERRSTACK(ERRCOUNT - 1); i++)
+   {
+      ERRCOUNT = REDQUEUE(i).pointer;
+
+      dyncheck(&tables->errstack, ERRSIZE * 2);
+
+      ERRSTACK(ERRCOUNT++) = REDQUEUE(i).state;
+   }
+
+/* Build the continuation string and determine what tokens become */
+/* legal after each prefix of the continuation has been inserted  */
+
+   build_continuation(tables);
+
+/* Use the valid tokens that have been generated to perform */
+/* a locally least-cost correction of the syntax error      */
+
+   if (STASIZE < ERRSIZE)
+      dynresize(&tables->stastack, ERRSIZE);
+
+/* Initialize the actual correction we have decided upon */
+
+   choice.token  = -1;
+   choice.prefix = -1;
+   choice.cost   = MAXCOST;
+   delete        = 0;
+
+   SCNCOUNT = 0;
+   DELCOUNT = 0;
+
+/* Now search ahead trying different corrections */
+
+   for (;;)
+   {
+/*    Find the cheapest terminal symbol which may be */
+/*    inserted to make the next input token legal    */
+
+      insert.token  = -1;
+      insert.prefix = -1;
+      insert.cost   = MAXCOST;
+
+      for (token = 1; token <= tables->tnumber; token++)
+	 if (!tables->followset[token] && token != INSERTION(1).token && !look_ahead(tables, token, 0, 1))
+	 {
+/*	    This token is legal in the current state, is not the first token */
+/*	    of the continuation string, and makes the next input token valid */
+
+/*	    Calculate the repair cost including a percentage of the default repair */
+/*	    cost depending on the number of valid tokens preceding another error   */
+
+	    cost = delete + tables->inscost[token];
+	    if (tables->context > 1)
+	       cost += (look_ahead(tables, token, 0, tables->context) * tables->defcost) / tables->context;
+
+	    if (cost < insert.cost)
+	    {
+/*	       This terminal is a new cheapest special-case insertion */
+
+	       insert.token = token;
+	       insert.cost  = cost;
+	    }
+	 }
+
+/*    Ensure that the next input token is available */
+
+      if (!TKNCOUNT)
+	 input_token(tables);
+
+      token        = TKNQUEUE(0).token;
+      prefix.token = -1;
+      if (tables->followset[token] >= 0)
+      {
+/*	 Calculate the cost of inserting this continuation prefix */
+
+	 cost = delete + INSERTION(tables->followset[token]).cost;
+	 if (tables->context > 0)
+	    cost += (look_ahead(tables, 0, tables->followset[token], tables->context) * tables->defcost) / tables->context;
+
+	 prefix.prefix = tables->followset[token];
+	 prefix.cost   = cost;
+      }
+      else
+      {
+	 prefix.prefix = 0;
+	 prefix.cost   = MAXCOST;
+      }
+
+/*    If either of these new repairs is cheaper than the previous */
+/*    least cost error repair we've found a new best repair       */
+
+      if (insert.cost < choice.cost || prefix.cost < choice.cost)
+      {
+	 choice = (insert.cost <= prefix.cost) ? insert : prefix;
+
+/*	 This is a new locally least-cost repair so delete */
+/*	 the tokens skipped over to get to this point      */
+
+	 if ((i = DELCOUNT + SCNCOUNT) > DELSIZE)
+	    dynresize(&tables->deletion, i);
+
+	 if (SCNCOUNT)
+	 {
+	    memcpy(&DELETION(DELCOUNT), &SCNSTACK(0), SCNCOUNT * SCNELEMENT);
+	    DELCOUNT += SCNCOUNT;
+
+#ifdef	  PARSER_STATS
+	    if (DELCOUNT > tables->deleterange)
+	       tables->deleterange = DELCOUNT;
+#endif /* PARSER_STATS */
+
+	    SCNCOUNT = 0;
+	 }
+      }
+
+/*    If the cost of deleting up to the next token is less */
+/*    than the cost of our best repair so far keep looking */
+
+      if (delete + tables->delcost[token] < choice.cost)
+      {
+/*	 Scan over the current token to look for a cheaper  */
+/*	 correction at a position further ahead		 */
+
+	 dyncheck(&tables->scnstack, SCNSIZE * 2);
+
+	 SCNSTACK(SCNCOUNT++) = TKNQUEUE(0);
+	 dynrotate(&tables->tknqueue, 1);
+
+#ifdef	  PARSER_STATS
+	 if (SCNCOUNT > tables->scanrange)
+	    tables->scanrange = SCNCOUNT;
+#endif /* PARSER_STATS */
+
+/*	 Increment the deletion cost up to this point */
+
+	 delete += tables->delcost[token];
+      }
+      else
+	 break;
+   }
+
+/* Put scanned (but not deleted) tokens back onto the input stream */
+
+   dynringcheck(&tables->tknqueue, TKNCOUNT + SCNCOUNT);
+   dynrotate(&tables->tknqueue, -SCNCOUNT);
+   for (i = 0; i < SCNCOUNT; i++)
+      TKNQUEUE(i) = SCNSTACK(i);
+   SCNCOUNT = 0;
+
+#ifdef	  PARSER_STATS
+   if (TKNCOUNT > tables->tokenrange)
+      tables->tokenrange = TKNCOUNT;
+#endif /* PARSER_STATS */
+
+/* If the best repair is a valid token insertion make it look like a */
+/* continuation prefix insertion to simplify displaying the repair   */
+
+   token = TKNQUEUE(0).token;
+   if (choice.token > 0)
+   {
+      choice.prefix            = 1;
+      INSERTION(1).token       = choice.token;
+      tables->followset[token] = 1;
+   }
+
+   record_repair(tables, tables->followset[token]);
+
+/* Clean up the deleted token symbol values */
+
+   for (i = 0; i < DELCOUNT; i++)
+      free_symbol(tables, DELETION(i).symbol);
+   DELCOUNT = 0;
+
+/* Push the inserted tokens in front of the input, giving them the  */
+/* same line and column of the token they are being inserted before */
+
+   if (tables->followset[token] > 0)
+   {
+      dynringcheck(&tables->tknqueue, TKNCOUNT + tables->followset[token]);
+      dynrotate(&tables->tknqueue, -tables->followset[token]);
+      for (i = 0; i < tables->followset[token]; i++)
+      {
+	 TKNQUEUE(i).where  = TKNQUEUE(tables->followset[token]).where;
+	 TKNQUEUE(i).token  = INSERTION(i + 1).token;
+	 TKNQUEUE(i).symbol = INSERTION(i + 1).symbol;
+	 TKNQUEUE(i).length = INSERTION(i + 1).length;
+      }
+   }
+   INSCOUNT = 0;
+
+#ifdef	  PARSER_STATS
+   if (TKNCOUNT > tables->tokenrange)
+      tables->tokenrange = TKNCOUNT;
+#endif /* PARSER_STATS */
+}
+
+
+static void *scan_ahead
+(
+   void *argument
+)
+{
+/* Scan the whole input with a private copy of the scanner, handing	*/
+/* each token to the parser preceded by the lexical errors found	*/
+/* before it, up to and including the end of file token			*/
+
+   pipelineentry *pipeline;		/* Queue shared with the parser */
+   sdt_tables	 *tables;		/* Private copy of the scanner data */
+   char		  install;		/* True if the token string is recorded */
+   int		  value;		/* Token found */
+   int		  i;
+
+   pipeline = (pipelineentry *) argument;
+   tables   = pipeline->tables;
+
+   do
+   {
+      value = scan_token(tables, &install);
+
+      for (i = 0; i < MSGCOUNT; i++)
+	 pass_token(pipeline, 0, false, &MSGQUEUE(i).point, &MSGQUEUE(i).last);
+      MSGCOUNT = 0;
+
+      pass_token(pipeline, value, install, &TKNQUEUE(TKNCOUNT).where, &tables->position);
+   }
+   while (value != tables->tnumber);
+
+   return(NULL);
+}
+
+
+int scan_char
+(
+   sdt_tables *tables,
+   location   *where
+)
+{
+/* Get the next input character for a direct coded scanner */
+
+   return(input_char(tables, where));
+}
+
+
+static void *scan_chunk
+(
+   void *data
+)
+{
+/* Scan a chunk of the input with the chunk's own copy of the scanner.	*/
+/* Tokens are recorded up to the first one starting at or after the	*/
+/* chunk's limit, or up to the end of the input				*/
+
+   chunkentry *chunk;			/* Chunk being scanned */
+   sdt_tables *tables;			/* Private copy of the scanner data */
+   char	       install;			/* Unused install flag of each token */
+   int	       value;			/* Token found */
+   long long   start;			/* Input offset of the token */
+
+   chunk  = (chunkentry *) data;
+   tables = chunk->tables;
+
+   for (;;)
+   {
+      value = scan_token(tables, &install);
+      start = POSITION(TKNQUEUE(TKNCOUNT).where);
+      if (value == tables->tnumber || start >= chunk->limit)
+	 break;
+
+      dyncheck(&chunk->spans, SPANSIZE * 2);
+
+      SPANS(SPANCOUNT  ).token  = value;
+      SPANS(SPANCOUNT  ).length = POSITION(tables->position) - start;
+      SPANS(SPANCOUNT++).start  = start;
+   }
+   chunk->stop    = start;
+   chunk->endfile = (value == tables->tnumber);
+   return(NULL);
+}
+
+
+static int scan_lazy
+(
+   sdt_tables *tables,
+   int	       ch,
+   location   *where
+)
+{
+/* Run the scanner automaton just as scan_token does, building each   */
+/* state and transition from the NFA the first time the input reaches */
+/* it.  The cache of states is flushed only between tokens, so the    */
+/* state numbers returned stay valid until the token is recorded      */
+
+   cacheentry *cache;			/* Scanner states built so far */
+   int	       final;			/* Number of last final state */
+   int	       state;			/* Current scanner state number */
+   int	       next;			/* Next scanner state number */
+   location    end;			/* Position of the last final state */
+   int	       i;
+
+   if (!tables->cache)
+      start_cache(tables);
+   else if (tables->cache->count > tables->lazystates)
+      flush_cache(tables);
+   cache = tables->cache;
+
+   final = -1;
+   ch    = tables->classmap[ch];
+   state = 1;
+   do
+   {
+      if (tables->lookahead)
+	 for (i = cache->states[state].tokenindex; i < cache->states[state].tokenindex + cache->states[state].tokencount; i++)
+	    tables->tokenend[LAZYTOKEN(i)] = *where;
+
+      if (cache->final[state])
+      {
+	 final = state;
+	 end   = *where;
+      }
+
+/*    Build the transition if this is the first time it is taken */
+
+      if (!(next = cache->next[state * tables->nfa->classes + ch]))
+      {
+	 next = next_state(tables, state, ch);
+	 cache->next[state * tables->nfa->classes + ch] = next;
+      }
+
+      if ((state = next) > 0)
+	 ch = tables->classmap[input_char(tables, where)];
+   }
+   while (state > 0);
+
+   if (!tables->lookahead && final >= 0)
+      tables->tokenend[cache->final[final]] = end;
+   return(final);
+}
+
+
+static int scan_parallel
+(
+   sdt_tables *tables,
+   int	      *token,
+   long long  *start,
+   int	      *length,
+   int	       count
+)
+{
+/* Return the tokens found by the scanning threads just as scan_tokens	*/
+/* returns the tokens it finds itself, scanning the next round of	*/
+/* chunks once every token of the last round has been returned		*/
+
+   parallelentry *parallel;
+   chunkentry	 *chunk;
+   location	  where;		/* Location of the token */
+   int		  n;
+
+   parallel = tables->parallel;
+   for (n = 0; n < count; )
+   {
+      if (!parallel || parallel->next >= parallel->count)
+      {
+	 if (parallel && parallel->endfile)
+	    break;
+
+	 scan_round(tables);
+	 parallel = tables->parallel;
+      }
+
+/*    Once the tokens of a chunk are used up, queue the errors after them */
+
+      chunk = &parallel->chunk[parallel->next];
+      if (chunk->first >= SPANCOUNT)
+      {
+	 move_messages(tables, chunk, chunk->stop);
+	 parallel->next++;
+	 continue;
+      }
+
+      token[n]  = SPANS(chunk->first).token;
+      start[n]  = SPANS(chunk->first).start;
+      length[n] = SPANS(chunk->first).length;
+      chunk->first++;
+
+/*    Queue the errors before the token, then complete the lines before */
+/*    it just as if the token had been shifted by the parser		*/
+
+      move_messages(tables, chunk, start[n]);
+
+      where = tables->lineend;
+      locate_position(&where, start[n]);
+
+      if (tables->listing || MSGCOUNT)
+	 flush_lines(tables, &where);
+      else
+	 if (tables->lineend.buffer != where.buffer)
+	    discard_lines(tables, &where);
+      n++;
+   }
+
+/* Since there is no "next line" after the end of the file */
+/* display all remaining queued errors			   */
+
+   if (parallel && parallel->endfile && parallel->next >= parallel->count)
+      while (MSGCOUNT)
+	 write_line(tables);
+   return(n);
 }
 
 
-static bool read_buffer
+static void scan_round
 (
-   sdt_tables *tables,
-   location   *where
+   sdt_tables *tables
 )
 {
-/* Read more data into buffer chain.  Returns true if another character is available */
-
-   int count;
-
-   if (where->buffer->next)
+/* Scan the next piece of the input, SCANCHUNK bytes for each thread, as */
+/* chunks in parallel.  The first chunk starts at the current position,	 */
+/* so its tokens are exact.  A later chunk is used from its first token	 */
+/* starting where the previous chunk stopped, which is usually one of	 */
+/* its first few, and is scanned again from there if there is none	 */
+
+   parallelentry *parallel;
+   chunkentry	 *chunk;
+   sdt_tables	 *copy;
+   location	  where;		/* Start of the chunk */
+   location	  nominal;		/* Start of the chunk before finding a newline */
+   location	  limit;		/* Nominal start of the next chunk */
+   long long	  base;			/* Input offset of the current position */
+   long long	  end;			/* Input offset of the end of the input */
+   long long	  stop;			/* Start of the first token not yet accepted */
+   int		  low, high, mid;
+   int		  i, j;
+
+   if (!tables->parallel)
+      start_parallel(tables);
+   parallel = tables->parallel;
+
+/* Divide the rest of the input into at most one chunk for each thread */
+
+   base = POSITION(tables->position);
+   end  = tables->bufferend->start + tables->bufferend->count;
+
+   parallel->count = (end - base + SCANCHUNK - 1) / SCANCHUNK;
+   if (parallel->count > parallel->size)
+      parallel->count = parallel->size;
+   else if (parallel->count < 1)
+      parallel->count = 1;
+   parallel->next = 0;
+
+/* A chunk after the first starts just past the first newline after its	 */
+/* nominal start, if there is one before the next chunk, since a newline */
+/* is likely to end a token						 */
+
+   where = tables->position;
+   for (i = 0; i < parallel->count; i++)
    {
-      where->buffer = where->buffer->next;
-      where->offset = 0;
-   }
-   else
-      if (!tables->endfile)
+      chunk = &parallel->chunk[i];
+      if (i)
       {
-	 if (where->buffer->count >= MAXBUFFER)
+	 locate_position(&where, base + i * (long long) SCANCHUNK);
+	 nominal = where;
+	 if (i + 1 < parallel->count)
 	 {
-	    if (!(where->buffer = (bufferentry *) malloc(sizeof(*tables->bufferlist))))
-	       out_of_memory();
+	    limit = where;
+	    locate_position(&limit, base + (i + 1) * (long long) SCANCHUNK);
+	 }
 
-	    where->buffer->next  = NULL;
-	    where->buffer->order = tables->bufferend->order + 1;
-	    where->buffer->count = 0;
+	 if (find_newline(tables, &where, (i + 1 < parallel->count) ? &limit : NULL))
+	    locate_position(&where, POSITION(where));
+	 else
+	    where = nominal;
+	 parallel->chunk[i - 1].limit = POSITION(where);
+      }
 
-	    tables->bufferend->next = where->buffer;
-	    tables->bufferend       = where->buffer;
+      chunk->message          = 0;
+      chunk->tables->position = where;
+      SPANCOUNT               = 0;
 
-#ifdef	  PARSER_STATS
-	    if (++tables->buffercount > tables->bufferrange)
-	       tables->bufferrange = tables->buffercount;
-#endif /* PARSER_STATS */
+      DYNCOUNT(chunk->tables->msgqueue) = 0;
+   }
+   chunk->limit = (base + parallel->count * (long long) SCANCHUNK < end) ? base + parallel->count * (long long) SCANCHUNK : end + 1;
 
-	    where->offset = 0;
-	 }
+/* The calling thread scans the first chunk while the others are scanned */
+/* by threads of their own						 */
 
-/*       Read data into buffer at end of array */
+   for (i = 1; i < parallel->count; i++)
+      if (pthread_create(&parallel->chunk[i].thread, NULL, &scan_chunk, &parallel->chunk[i]))
+      {
+	 perror("can't create scanning thread");
+	 exit(1);
+      }
+   scan_chunk(&parallel->chunk[0]);
+   for (i = 1; i < parallel->count; i++)
+      pthread_join(parallel->chunk[i].thread, NULL);
+
+/* Starting from any token boundary the scanner finds the same tokens, so */
+/* once a chunk has a token which starts where the previous chunk stopped */
+/* it matches the input scanned from the current position from then on.	  */
+/* Its tokens and errors before that point are discarded		  */
+
+   chunk        = &parallel->chunk[0];
+   chunk->first = 0;
+   for (i = 1; i < parallel->count; i++)
+   {
+      stop  = chunk->stop;
+      chunk = &parallel->chunk[i];
+      copy  = chunk->tables;
 
-	 if ((count = read(tables->inputfd, &tables->bufferend->buffer[tables->bufferend->count], MAXBUFFER - tables->bufferend->count)) < 0)
-	 {
-	    perror("error reading input file");
-	    exit(1);
-	 }
+      for (j = 0; j < DYNCOUNT(copy->msgqueue) && POSITION(DYNRING(errorentry, copy->msgqueue, j).point) < stop; j++)
+	 free(DYNRING(errorentry, copy->msgqueue, j).message);
+      chunk->message = j;
 
-	 if (count)
-	    tables->bufferend->count += count;
+      for (low = 0, high = SPANCOUNT; low < high; )
+	 if (SPANS(mid = (low + high) / 2).start < stop)
+	    low = mid + 1;
 	 else
-	    tables->endfile = true;
+	    high = mid;
+
+      if (low < SPANCOUNT ? SPANS(low).start != stop : chunk->stop != stop)
+      {
+/*	 No token starts there, so discard the rest of the chunk as well  */
+/*	 and scan it again from that point				  */
+
+	 for (; j < DYNCOUNT(copy->msgqueue); j++)
+	    free(DYNRING(errorentry, copy->msgqueue, j).message);
+	 DYNCOUNT(copy->msgqueue) = 0;
+
+	 chunk->message = 0;
+	 copy->position = tables->position;
+	 SPANCOUNT      = 0;
+
+	 locate_position(&copy->position, stop);
+	 scan_chunk(chunk);
+	 low = 0;
       }
-   return(where->offset < where->buffer->count);
+      chunk->first = low;
+   }
+
+/* Scanning resumes where the last chunk stopped */
+
+   parallel->endfile = chunk->endfile;
+   locate_position(&tables->position, chunk->stop);
 }
 
 
-void record_error
+static int scan_states
 (
    sdt_tables *tables,
-   location   *point,
-   char	      *fmt,
-   ...
+   int	       ch,
+   location   *where
 )
 {
-/* Format syntax/semantic error and enqueue it */
+/* Run the scanner automaton just as scan_token does, but take the */
+/* data for each state from its entry in the fused state table	   */
 
-   va_list args;
+   stateentry *entry;			/* Fused data for the current state */
+   int	       final;			/* Number of last final state */
+   int	       state;			/* Current scanner state number */
+   location    end;			/* Position of the last final state */
+   int	       i;
 
-   if (fmt)
+   final = -1;
+   ch    = tables->classmap[ch];
+   state = 1;
+   do
    {
-/*    Try to format the error message into a string */
+      entry = &tables->scanstate[state];
 
-      va_start(args, fmt);
-      CHRCOUNT = vsnprintf(&CHRSTRING(0), CHRSIZE, fmt, args);
-      va_end(args);
-      if (CHRCOUNT < 0)
-      {
-	 fprintf(stderr, "error encountered while recording message \"%s\" (glibc < 2.0.6?)\n", fmt);
-	 exit(1);
-      }
+      if (tables->lookahead)
+	 for (i = entry->tokenindex; i < entry->tokenindex + entry->tokencount; i++)
+	    tables->tokenend[tables->tokentable[i]] = *where;
 
-      if (CHRCOUNT >= CHRSIZE)
+      if (entry->final)
       {
-/*	 Increase the string length to accomodate the error message */
+	 final = state;
+	 end   = *where;
+      }
 
-	 dynresize(&tables->chrstring, CHRCOUNT + 1);
+      if (!tables->scheck.entries)
+	 i = entry->sbase + ch;
+      else
+	 for (i = entry->sbase + ch; TABLE(tables->scheck, i) != state && (state = entry->sdefault); i = entry->sbase + ch)
+	    entry = &tables->scanstate[state];
 
-	 va_start(args, fmt);
-	 CHRCOUNT = vsnprintf(&CHRSTRING(0), CHRSIZE, fmt, args);
-	 va_end(args);
+      if (state && (state = TABLE(tables->snext, i)))
+      {
+	 if (tables->scanstate[state].loop)
+	    skip_run(tables, state);
+	 ch = tables->classmap[input_char(tables, where)];
       }
-
-      enqueue_error(tables, point, &CHRSTRING(0));
    }
-   else
-
-/*    This is an undefined character encountered by the scanner */
+   while (state);
 
-      enqueue_error(tables, point, NULL);
+   if (!tables->lookahead && final >= 0)
+      tables->tokenend[tables->scanstate[final].final] = end;
+   return(final);
 }
 
 
-static void record_repair
+static int scan_token
 (
    sdt_tables *tables,
-   int	       insert
+   char	      *install
 )
 {
-/* Report error repair as one or more syntax errors */
+/* Find the next token in the input file, skipping ignored tokens and */
+/* recording lexical errors.  The start of the token is left in the   */
+/* next free token queue entry and its end in the input position      */
 
-   location where;
-   int	    token;
-   char	   *msg;
-   int	    i, j;
+   int	    ch;				/* Current character (or its class) in token */
+   int	    final;			/* Number of last final state */
+   int	    state;			/* Current scanner state number */
+   location where;			/* Current position in token */
+   location end;			/* Position of the last final state */
+   int	    token;			/* Token found */
+   int	    i;
 
-   i = 0;
-   while (i < DELCOUNT)
+/* Interpret the scanner tables to determine the next token */
+
+   dynringcheck(&tables->tknqueue, TKNCOUNT + 1);
+
+   for (;;)
    {
-      where = DELETION(i).where;
+/*    Record the current position of the token */
 
-/*    If there is no insertion or the deleted tokens are  */
-/*    on multiple lines, report this line as deletions    */
-/*    only.  If there is an insertion and all the deleted */
-/*    tokens are on one line report it as a replacement   */
+      ch = input_char(tables, &where);
+      TKNQUEUE(TKNCOUNT).where = where;
 
-      for (j = i + 1; j < DELCOUNT; j++)
-	 if (DELETION(j).locus.offset != DELETION(j - 1).locus.offset || DELETION(j).locus.buffer != DELETION(j - 1).locus.buffer)
-	    break;
+/*    A direct coded scanner runs the whole automaton itself, as  */
+/*    does the fused state table, unless failed states must be	  */
+/*    remembered.  A scanner given as an NFA always builds its	  */
+/*    states lazily						  */
+
+      if (tables->nfa)
+	 final = scan_lazy(tables, ch, &where);
+      else if (tables->scancode && !tables->memoize)
+	 final = (*tables->scancode)(tables, ch, &where);
+      else if (tables->scanstate && !tables->memoize)
+	 final = scan_states(tables, ch, &where);
+      else
+      {
+/*	 Initialize the number of the last encountered final state */
 
-      CHRCOUNT = 0;
-      append_message(tables, "%s", (j < DELCOUNT || !insert) ? "Deleted:" : "Replaced:");
+	 final = -1;
 
-      while (i < j)
-	 if (!DELETION(i).symbol)
+/*	 Run through the finite-state automaton until no transition is possible */
+
+	 ch    = tables->classmap[ch];
+	 state = 1;
+	 do
 	 {
-	    token = DELETION(i++).token;
-	    append_message(tables, " %.*s", tables->stringindex[token + 1] - tables->stringindex[token], &tables->stringtable[tables->stringindex[token]]);
+/*	    If this state is already known to fail at this position there */
+/*	    is no longer token to be found, otherwise remember the state  */
+/*	    in case no final state follows it				  */
+
+	    if (tables->memoize)
+	    {
+	       if (find_failure(tables, state, POSITION(where)))
+		  break;
+
+	       if (tables->final[state])
+		  FAILCOUNT = 0;
+	       else
+	       {
+		  dyncheck(&tables->failpath, FAILSIZE * 2);
+
+		  FAILPATH(FAILCOUNT  ).state    = state;
+		  FAILPATH(FAILCOUNT++).position = POSITION(where);
+	       }
+	    }
+
+/*	    Record the end of token position for all tokens ending in this   */
+/*	    state.  Without lookahead expressions every token ends where its */
+/*	    final state is reached, so only that position need be recorded   */
+
+	    if (tables->lookahead)
+	       for (i = tables->tokenindex[state]; i < tables->tokenindex[state + 1]; i++)
+		  tables->tokenend[tables->tokentable[i]] = where;
+
+/*	    Remember the last final state encountered */
+
+	    if (tables->final[state])
+	    {
+	       final = state;
+	       end   = where;
+	    }
+
+/*	    A direct indexed scanner has a transition for every state */
+/*	    and class, otherwise search through the scanner default   */
+/*	    state chain until a valid transition is found	      */
+
+	    if (!tables->scheck.entries)
+	       i = TABLE(tables->sbase, state) + ch;
+	    else
+	       for (i = TABLE(tables->sbase, state) + ch; TABLE(tables->scheck, i) != state && (state = TABLE(tables->sdefault, state)); i = TABLE(tables->sbase, state) + ch)
+		  ;
+
+/*	    If a new state must be checked get the next input	 */
+/*	    character, first passing over any run of characters	 */
+/*	    which would only return the scanner to the new state */
+/*	    unless every position is needed to find failures	 */
+
+	    if (state && (state = TABLE(tables->snext, i)))
+	    {
+	       if (tables->loopindex[state] < tables->loopindex[state + 1] && !tables->memoize)
+		  skip_run(tables, state);
+	       ch = tables->classmap[input_char(tables, &where)];
+	    }
 	 }
-	 else
-	    append_message(tables, " %s", DELETION(i++).symbol);
+	 while (state);
 
-/*    If this message is complete, record it */
+	 if (tables->memoize && FAILCOUNT)
+	    record_failures(tables, POSITION(TKNQUEUE(TKNCOUNT).where));
 
-      if (i < DELCOUNT || !insert)
-      {
-	 msg = strdup(&CHRSTRING(0));
-	 record_error(tables, &where, "%s", msg);
-	 free(msg);
+	 if (!tables->lookahead && final >= 0)
+	    tables->tokenend[tables->final[final]] = end;
       }
-   }
-
-/* If tokens are being inserted display them as a replacement or insertion */
 
-   if (insert)
-   {
-      if (!DELCOUNT)
+      if (final < 0)
       {
-/*	 If there are no deleted tokens we start an insertion message */
+/*	 Since we have encountered no final state, record a lexical error, */
+/*	 skip a character in the input buffer, and look for a token again  */
 
-	 where = TKNQUEUE(0).where;
+	 record_error(tables, &TKNQUEUE(TKNCOUNT).where, NULL);
 
-	 CHRCOUNT = 0;
-	 append_message(tables, "%s", "Inserted:");
+	 tables->position = TKNQUEUE(TKNCOUNT).where;
+	 tables->position.offset++;
       }
       else
       {
-/*	 Otherwise we append the inserted tokens to the existing replacement message */
-
-	 append_message(tables, "%s", "  with ");
+/*	 Reset the position in the buffer to the end of the token encountered */
 
-/*	 If any of the tokens being inserted are the same as tokens that were */
-/*	 deleted, move the deleted symbol's value to the insertion string     */
+	 tables->position = tables->tokenend[tables->final[final]];
 
-	 for (i = 1; i <= insert; i++)
-	 {
-/*	    Search the deleted tokens for the same token value with a symbol */
+/*	 If this is not an ignored token, we're done */
 
-	    for (j = 0; j < DELCOUNT; j++)
-	       if (DELETION(j).token == INSERTION(i).token && DELETION(j).symbol)
-	       {
-		  INSERTION(i).symbol = DELETION(j).symbol;
-		  DELETION(j).symbol  = NULL;
-		  break;
-	       }
-	 }
+	 if (tables->final[final] <= tables->tnumber)
+	    break;
       }
+   }
 
-/*    Append the inserted tokens */
-
-      for (i = 1; i <= insert; i++)
-	 if (!INSERTION(i).symbol)
-	 {
-	    token = INSERTION(i).token;
-	    append_message(tables, " %.*s", tables->stringindex[token + 1] - tables->stringindex[token], &tables->stringtable[tables->stringindex[token]]);
-	 }
-	 else
-	    append_message(tables, " %s", INSERTION(i).symbol);
+/* If the token's string may be a keyword look it up, and if it is */
+/* one return the keyword instead				   */
 
-/*    And record the completed error message */
+   token    = tables->final[final];
+   *install = tables->install[final];
 
-      msg = strdup(&CHRSTRING(0));
-      record_error(tables, &where, "%s", msg);
-      free(msg);
+   if (tables->keywords && tables->keywords->check[token] && (i = find_keyword(tables, token)) >= 0)
+   {
+      token    = tables->keywords->token[i];
+      *install = tables->keywords->install[i];
    }
+   return(token);
 }
 
 
-static void repair_error
+int scan_tokens
 (
-   sdt_tables *tables
+   sdt_tables *tables,
+   int	      *token,
+   long long  *start,
+   int	      *length,
+   int	       count
 )
 {
-/* Determine the locally least-cost error repair for this syntax error */
-
-   errorrepair choice;			/* Least cost repair (insert or prefix) */
-   errorrepair insert;			/* Valid token insertion repair */
-   errorrepair prefix;			/* Continuation prefix insertion repair */
-   int	       delete;			/* Total cost of deleted tokens */
-   int	       token;			/* Current token being checked */
-   int	       cost;			/* Cost of current correction */
-   int	       i;
+/* Run only the scanner, filling the caller's arrays with the token	*/
+/* value, starting offset, and length of up to count tokens.  No	*/
+/* token strings are copied and install_token is never called.  The	*/
+/* number of tokens found is returned, which is less than count only	*/
+/* at the end of the input						*/
 
-/* Make a local copy of the states on the parse stack */
+   char install;			/* Unused install flag of each token */
+   int	value;				/* Token found */
+   int	n;
 
-   if (ERRSIZE < PARSIZE)
-      dynresize(&tables->errstack, PARSIZE);
-   for (i = 0; i < PARCOUNT; i++)
-      ERRSTACK(i) = PARSTACK(i).state;
-   ERRCOUNT = PARCOUNT;
+/* With several threads and the whole input in memory the input is  */
+/* instead scanned as chunks in parallel			    */
 
-/* Because of shiftreduce actions, the state on the top of the parse stack */
-/* may not be real.  Perform queued reduce actions until the parser is in  */
-/* a real state.  Because shiftreduce actions have no corresponding state  */
-/* applying them has no impact on future error repair quality.		   */
+   if (tables->parallel || (tables->scanthreads > 1 && tables->endfile))
+      return(scan_parallel(tables, token, start, length, count));
 
-   for (i = 0; !ERRSTACK(ERRCOUNT - 1); i++)
+   for (n = 0; n < count; n++)
    {
-      ERRCOUNT = REDQUEUE(i).pointer;
+/*    The end of input sentinel is not returned.  Since there is no */
+/*    "next line" display all remaining queued errors		    */
+
+      if ((value = scan_token(tables, &install)) == tables->tnumber)
+      {
+	 while (MSGCOUNT)
+	    write_line(tables);
+	 break;
+      }
+
+      token[n]  = value;
+      start[n]  = POSITION(TKNQUEUE(TKNCOUNT).where);
+      length[n] = POSITION(tables->position) - start[n];
+
+/*    All lines up to the token are complete, just as if it had been */
+/*    shifted by the parser					     */
+
+      if (tables->listing || MSGCOUNT)
+	 flush_lines(tables, &TKNQUEUE(TKNCOUNT).where);
+      else
+	 if (tables->lineend.buffer != TKNQUEUE(TKNCOUNT).where.buffer)
+	    discard_lines(tables, &TKNQUEUE(TKNCOUNT).where);
+   }
+   return(n);
+}
+
+
+static void setup_parser
+(
+   sdt_tables *tables,
+   void	     (*action)(sdt_tables *, int),
+   void	     (*token)(sdt_tables *, tokenentry *)
+)
+{
+   int length;
+   int i;
+
+/* Save perform_action and install_token callbacks */
+
+   tables->action  = action;
+   tables->token   = token;
+
+   tables->listing = false;
+   tables->slices  = false;
+   tables->memoize = false;
+
+/* Start scanning at the beginning of the first input buffer */
+
+   for (tables->bufferend = tables->bufferlist; tables->bufferend->next; tables->bufferend = tables->bufferend->next)
+      ;
+   tables->bufferpool = NULL;
+   tables->readahead  = 0;
+   tables->reader     = NULL;
+   tables->failtable  = NULL;
+   tables->failsize   = 0;
+   tables->failused   = 0;
+   tables->failmax    = -1;
+   tables->lazystates = LAZYSTATES;
+   tables->cache      = NULL;
+
+   tables->scanthreads = 0;
+   tables->parallel    = NULL;
+   tables->scanahead   = 0;
+   tables->pipeline    = NULL;
 
-      dyncheck(&tables->errstack, ERRSIZE * 2);
+   tables->position.buffer = tables->bufferlist;
+   tables->position.offset = 0;
+   tables->lineno          = 0;
 
-      ERRSTACK(ERRCOUNT++) = REDQUEUE(i).state;
-   }
+/* And record the current position in the buffer */
 
-/* Build the continuation string and determine what tokens become */
-/* legal after each prefix of the continuation has been inserted  */
+   tables->unwritten  = tables->position;
+   tables->lineend    = tables->position;
+   tables->msgwritten = false;
 
-   build_continuation(tables);
+   if (!(tables->tokenend  = (location *) malloc((tables->ntokens + 2) * sizeof(*tables->tokenend))) ||
+       !(tables->followset = (int *)      malloc((tables->tnumber + 1) * sizeof(*tables->followset))))
+      out_of_memory();
 
-/* Use the valid tokens that have been generated to perform */
-/* a locally least-cost correction of the syntax error      */
+/* Allocate and initialize reallocatable arrays */
 
-   if (STASIZE < ERRSIZE)
-      dynresize(&tables->stastack, ERRSIZE);
+   dynalloc(&tables->chrstring, sizeof(char), 80);
+   dynalloc(&tables->msgqueue, sizeof(errorentry), INITIAL_MSGQUEUE_SIZE);
+   dynalloc(&tables->parstack, sizeof(parseentry), INITIAL_PARSTACK_SIZE);
+   dynalloc(&tables->redqueue, sizeof(reduceentry), INITIAL_REDQUEUE_SIZE);
+   dynalloc(&tables->redstate, sizeof(int), INITIAL_REDSTATE_SIZE);
+   dynalloc(&tables->tknqueue, sizeof(tokenentry), INITIAL_TKNQUEUE_SIZE);
+   dynalloc(&tables->errstack, sizeof(int), INITIAL_ERRSTACK_SIZE);
+   dynalloc(&tables->lclstack, sizeof(int), INITIAL_LCLSTACK_SIZE);
+   dynalloc(&tables->stastack, sizeof(int), INITIAL_STASTACK_SIZE);
+   dynalloc(&tables->chkqueue, sizeof(int), INITIAL_CHKQUEUE_SIZE);
+   dynalloc(&tables->scnstack, sizeof(tokenentry), INITIAL_SCNSTACK_SIZE);
+   dynalloc(&tables->deletion, sizeof(tokenentry), INITIAL_DELETION_SIZE);
+   dynalloc(&tables->insertion, sizeof(insertentry), INITIAL_INSERTION_SIZE);
+   dynalloc(&tables->failpath, sizeof(failentry), INITIAL_FAILPATH_SIZE);
 
-/* Initialize the actual correction we have decided upon */
+/* Initialize map of symbol names to token numbers */
 
-   choice.token  = -1;
-   choice.prefix = -1;
-   choice.cost   = MAXCOST;
-   delete        = 0;
+   for (i = 0; i < HASH_TABLE_SIZE; i++)
+      tables->nametable[i] = NULL;
+   for (i = 1; i <= tables->tnumber; i++)
+   {
+      length = tables->stringindex[i + 1] - tables->stringindex[i];
 
-   SCNCOUNT = 0;
-   DELCOUNT = 0;
+/*    Double the size of the string array until it can hold the name */
 
-/* Now search ahead trying different corrections */
+      while (CHRSIZE < length + 1)
+	 dynresize(&tables->chrstring, CHRSIZE * 2);
 
-   for (;;)
-   {
-/*    Find the cheapest terminal symbol which may be */
-/*    inserted to make the next input token legal    */
+/*    Save the token name and number */
 
-      insert.token  = -1;
-      insert.prefix = -1;
-      insert.cost   = MAXCOST;
+      snprintf(&CHRSTRING(0), CHRSIZE, "%.*s", length, &tables->stringtable[tables->stringindex[i]]);
+      lookup_token(tables, &CHRSTRING(0), TERMINAL, INSERT)->token = i;
+   }
+   for (i = tables->tnumber + 1; i <= tables->tnumber + tables->ntnumber; i++)
+   {
+      length = tables->stringindex[i + 1] - tables->stringindex[i];
+      while (CHRSIZE < length + 1)
+	 dynresize(&tables->chrstring, CHRSIZE * 2);
+      snprintf(&CHRSTRING(0), CHRSIZE, "%.*s", length, &tables->stringtable[tables->stringindex[i]]);
+      lookup_token(tables, &CHRSTRING(0), NONTERMINAL, INSERT)->token = i;
+   }
 
-      for (token = 1; token <= tables->tnumber; token++)
-	 if (!tables->followset[token] && token != INSERTION(1).token && !look_ahead(tables, token, 0, 1))
-	 {
-/*	    This token is legal in the current state, is not the first token */
-/*	    of the continuation string, and makes the next input token valid */
+#ifdef	  PARSER_STATS
+   tables->buffercount  = 1;
+   tables->bufferrange  = tables->buffercount;
+   tables->messagerange = 0;
+   tables->parserange   = 0;
+   tables->reducerange  = 0;
+   tables->tokenrange   = 0;
+   tables->scanrange    = 0;
+   tables->deleterange  = 0;
+   tables->insertrange  = 0;
+#endif /* PARSER_STATS */
+}
 
-/*	    Calculate the repair cost including a percentage of the default repair */
-/*	    cost depending on the number of valid tokens preceding another error   */
 
-	    cost = delete + tables->inscost[token];
-	    if (tables->context > 1)
-	       cost += (look_ahead(tables, token, 0, tables->context) * tables->defcost) / tables->context;
+static void skip_run
+(
+   sdt_tables *tables,
+   int	       state
+)
+{
+/* Advance the input position over the run of characters on which this   */
+/* scanner state loops back to itself.  The scanner would only record	 */
+/* the same end of token and final values for each of them, so the run	 */
+/* can be passed over without interpreting the tables.  The run stops at */
+/* the end of the current buffer, where input_char takes over again	 */
+
+   unsigned char *data;			/* Data in the current buffer */
+   int		  offset;		/* Offset of the character being checked */
+   int		  first;		/* First loop range for this state */
+   int		  last;			/* End of loop ranges for this state */
+   int		  i;
+#ifdef	  __SSE2__
+   __m128i	  chunk;		/* Sixteen characters from the buffer */
+   __m128i	  match;		/* Characters within one of the ranges */
+   int		  mask;			/* One bit for each character within a range */
+#endif /* __SSE2__ */
+
+   data   = tables->position.buffer->buffer;
+   offset = tables->position.offset;
+   first  = tables->loopindex[state];
+   last   = tables->loopindex[state + 1];
+
+#ifdef	  __SSE2__
+/* Check sixteen characters at a time.  A character is within low:high if */
+/* subtracting low (modulo 256) and then high - low (saturating) is zero  */
+
+   while (offset + 16 <= tables->position.buffer->count)
+   {
+      chunk = _mm_loadu_si128((__m128i *) &data[offset]);
+      match = _mm_setzero_si128();
+      for (i = first; i < last; i += 2)
+	 match = _mm_or_si128(match, _mm_cmpeq_epi8(_mm_subs_epu8(_mm_sub_epi8(chunk, _mm_set1_epi8(tables->looptable[i])),
+							      _mm_set1_epi8(tables->looptable[i + 1] - tables->looptable[i])),
+						    _mm_setzero_si128()));
+      if ((mask = _mm_movemask_epi8(match)) != 0xFFFF)
+      {
+	 offset += __builtin_ctz(~mask);
+	 break;
+      }
+      offset += 16;
+   }
+#endif /* __SSE2__ */
 
-	    if (cost < insert.cost)
-	    {
-/*	       This terminal is a new cheapest special-case insertion */
+/* Check the remaining characters one at a time */
 
-	       insert.token = token;
-	       insert.cost  = cost;
-	    }
-	 }
+   while (offset < tables->position.buffer->count)
+   {
+      for (i = first; i < last && (data[offset] < tables->looptable[i] || data[offset] > tables->looptable[i + 1]); i += 2)
+	 ;
+      if (i >= last)
+	 break;
+      offset++;
+   }
 
-/*    Ensure that the next input token is available */
+   tables->position.offset = offset;
+}
 
-      if (!TKNCOUNT)
-	 input_token(tables);
 
-      token        = TKNQUEUE(0).token;
-      prefix.token = -1;
-      if (tables->followset[token] >= 0)
-      {
-/*	 Calculate the cost of inserting this continuation prefix */
+static void start_cache
+(
+   sdt_tables *tables
+)
+{
+/* Allocate the cache of lazily built scanner states */
 
-	 cost = delete + INSERTION(tables->followset[token]).cost;
-	 if (tables->context > 0)
-	    cost += (look_ahead(tables, 0, tables->followset[token], tables->context) * tables->defcost) / tables->context;
+   cacheentry *cache;
+   nfaentry   *nfa;
 
-	 prefix.prefix = tables->followset[token];
-	 prefix.cost   = cost;
-      }
-      else
-      {
-	 prefix.prefix = 0;
-	 prefix.cost   = MAXCOST;
-      }
+   nfa = tables->nfa;
+   if (!(cache = tables->cache = (cacheentry *) malloc(sizeof(*cache))))
+      out_of_memory();
 
-/*    If either of these new repairs is cheaper than the previous */
-/*    least cost error repair we've found a new best repair       */
+   cache->size = INITIAL_CACHE_SIZE;
+   if (!(cache->states  = (lazyentry *) malloc(cache->size * sizeof(*cache->states))) ||
+       !(cache->final   = (int *)       malloc(cache->size * sizeof(*cache->final))) ||
+       !(cache->install = (char *)      malloc(cache->size * sizeof(*cache->install))) ||
+       !(cache->next    = (int *)       malloc(cache->size * nfa->classes * sizeof(*cache->next))) ||
+       !(cache->bucket  = (int *)       malloc(2 * cache->size * sizeof(*cache->bucket))) ||
+       !(cache->merge   = (int *)       malloc((nfa->positions + 1) * sizeof(*cache->merge))) ||
+       !(cache->mark    = (int *)       calloc(nfa->positions + 1, sizeof(*cache->mark))))
+      out_of_memory();
+   dynalloc(&cache->positions, sizeof(int), INITIAL_LAZYSET_SIZE);
+   dynalloc(&cache->tokens, sizeof(int), INITIAL_LAZYTOKEN_SIZE);
+   cache->stamp = 0;
 
-      if (insert.cost < choice.cost || prefix.cost < choice.cost)
-      {
-	 choice = (insert.cost <= prefix.cost) ? insert : prefix;
+   tables->final   = cache->final;
+   tables->install = cache->install;
 
-/*	 This is a new locally least-cost repair so delete */
-/*	 the tokens skipped over to get to this point      */
+   flush_cache(tables);
+}
 
-	 if ((i = DELCOUNT + SCNCOUNT) > DELSIZE)
-	    dynresize(&tables->deletion, i);
 
-	 if (SCNCOUNT)
-	 {
-	    memcpy(&DELETION(DELCOUNT), &SCNSTACK(0), SCNCOUNT * SCNELEMENT);
-	    DELCOUNT += SCNCOUNT;
+static void start_parallel
+(
+   sdt_tables *tables
+)
+{
+/* Allocate a chunk for each scanning thread with its own copy of the */
+/* scanner data							      */
 
-#ifdef	  PARSER_STATS
-	    if (DELCOUNT > tables->deleterange)
-	       tables->deleterange = DELCOUNT;
-#endif /* PARSER_STATS */
+   parallelentry *parallel;
+   chunkentry	 *chunk;
+   int		  i;
 
-	    SCNCOUNT = 0;
-	 }
-      }
+   if (!(parallel = tables->parallel = (parallelentry *) malloc(sizeof(*parallel) + tables->scanthreads * sizeof(*parallel->chunk))))
+      out_of_memory();
 
-/*    If the cost of deleting up to the next token is less */
-/*    than the cost of our best repair so far keep looking */
+   parallel->size    = tables->scanthreads;
+   parallel->count   = 0;
+   parallel->next    = 0;
+   parallel->endfile = false;
+   parallel->chunk   = (chunkentry *) &parallel[1];
 
-      if (delete + tables->delcost[token] < choice.cost)
-      {
-/*	 Scan over the current token to look for a cheaper  */
-/*	 correction at a position further ahead		 */
+   for (i = 0; i < parallel->size; i++)
+   {
+      chunk          = &parallel->chunk[i];
+      chunk->tables  = copy_scanner(tables);
+      chunk->first   = 0;
+      chunk->message = 0;
+      dynalloc(&chunk->spans, sizeof(spanentry), INITIAL_SPANS_SIZE);
+   }
+}
 
-	 dyncheck(&tables->scnstack, SCNSIZE * 2);
 
-	 SCNSTACK(SCNCOUNT++) = TKNQUEUE(0);
-	 if (--TKNCOUNT)
-	    memmove(&TKNQUEUE(0), &TKNQUEUE(1), TKNCOUNT * TKNELEMENT);
+static void start_pipeline
+(
+   sdt_tables *tables
+)
+{
+/* Create the scanner thread along with its copy of the scanner data */
+/* and its token queue						     */
 
-#ifdef	  PARSER_STATS
-	 if (SCNCOUNT > tables->scanrange)
-	    tables->scanrange = SCNCOUNT;
-#endif /* PARSER_STATS */
+   pipelineentry *pipeline;
 
-/*	 Increment the deletion cost up to this point */
+   if (!(pipeline = (pipelineentry *) malloc(sizeof(*pipeline) + tables->scanahead * sizeof(*pipeline->queue))))
+      out_of_memory();
 
-	 delete += tables->delcost[token];
-      }
-      else
-	 break;
+   pipeline->tables  = copy_scanner(tables);
+   pipeline->size    = tables->scanahead;
+   pipeline->queue   = (scannedentry *) &pipeline[1];
+   pipeline->head    = 0;
+   pipeline->tail    = 0;
+   pipeline->endfile = false;
+   sem_init(&pipeline->fillcount, 0, 0);
+   sem_init(&pipeline->fillspace, 0, pipeline->size);
+
+   tables->pipeline = pipeline;
+   if (pthread_create(&pipeline->thread, NULL, &scan_ahead, pipeline))
+   {
+      perror("can't create scanner thread");
+      exit(1);
    }
+}
 
-/* Put scanned (but not deleted) tokens back onto the input stream */
 
-   if ((i = TKNCOUNT + SCNCOUNT) > TKNSIZE)
-      dynresize(&tables->tknqueue, i);
-   if (TKNCOUNT)
-      memmove(&TKNQUEUE(SCNCOUNT), &TKNQUEUE(0), TKNCOUNT * TKNELEMENT);
-   for (i = 0; i < SCNCOUNT; i++)
-      TKNQUEUE(i) = SCNSTACK(i);
-   TKNCOUNT += SCNCOUNT;
-   SCNCOUNT  = 0;
+static void start_reader
+(
+   sdt_tables *tables
+)
+{
+/* Create the read ahead thread along with its two buffer queues */
 
-#ifdef	  PARSER_STATS
-   if (TKNCOUNT > tables->tokenrange)
-      tables->tokenrange = TKNCOUNT;
-#endif /* PARSER_STATS */
+   readerentry *reader;
 
-/* If the best repair is a valid token insertion make it look like a */
-/* continuation prefix insertion to simplify displaying the repair   */
+   if (!(reader = (readerentry *) malloc(sizeof(*reader) + 2 * tables->readahead * sizeof(*reader->filled))))
+      out_of_memory();
 
-   token = TKNQUEUE(0).token;
-   if (choice.token > 0)
+   reader->size      = tables->readahead;
+   reader->filled    = (bufferentry **) &reader[1];
+   reader->fillhead  = 0;
+   reader->filltail  = 0;
+   reader->spare     = &reader->filled[reader->size];
+   reader->sparehead = 0;
+   reader->sparetail = 0;
+   sem_init(&reader->fillcount,  0, 0);
+   sem_init(&reader->fillspace,  0, reader->size);
+   sem_init(&reader->sparecount, 0, 0);
+   sem_init(&reader->sparespace, 0, reader->size);
+
+   tables->reader = reader;
+   if (pthread_create(&reader->thread, NULL, &read_ahead, tables))
    {
-      choice.prefix            = 1;
-      INSERTION(1).token       = choice.token;
-      tables->followset[token] = 1;
+      perror("can't create read ahead thread");
+      exit(1);
    }
+}
 
-   record_repair(tables, tables->followset[token]);
 
-/* Clean up the deleted token symbol values */
+static void store_failure
+(
+   sdt_tables *tables,
+   failentry  *failure,
+   long long   start
+)
+{
+/* Add a failed scanner state to the failure table, reusing the first */
+/* entry passed whose position is before start, the current token     */
 
-   for (i = 0; i < DELCOUNT; i++)
-      free(DELETION(i).symbol);
-   DELCOUNT = 0;
+   unsigned int i;
+   int		reuse;			/* Entry that may be reused (-1 if none) */
 
-/* Push the inserted tokens in front of the input, giving them the  */
-/* same line and column of the token they are being inserted before */
+   reuse = -1;
+   for (i = hash_failure(failure->state, failure->position) & (tables->failsize - 1); tables->failtable[i].state; i = (i + 1) & (tables->failsize - 1))
+      if (tables->failtable[i].state == failure->state && tables->failtable[i].position == failure->position)
+	 return;
+      else
+	 if (reuse < 0 && tables->failtable[i].position < start)
+	    reuse = i;
 
-   if (tables->followset[token] > 0)
+   if (reuse < 0)
    {
-      if ((i = TKNCOUNT + tables->followset[token]) > TKNSIZE)
-	 dynresize(&tables->tknqueue, i);
-
-      memmove(&TKNQUEUE(tables->followset[token]), &TKNQUEUE(0), TKNCOUNT * TKNELEMENT);
-      for (i = 0; i < tables->followset[token]; i++)
-      {
-	 TKNQUEUE(i).locus  = TKNQUEUE(tables->followset[token]).locus;
-	 TKNQUEUE(i).where  = TKNQUEUE(tables->followset[token]).where;
-	 TKNQUEUE(i).token  = INSERTION(i + 1).token;
-	 TKNQUEUE(i).symbol = INSERTION(i + 1).symbol;
-      }
-      TKNCOUNT += tables->followset[token];
+      reuse = i;
+      tables->failused++;
    }
-   INSCOUNT = 0;
-
-#ifdef	  PARSER_STATS
-   if (TKNCOUNT > tables->tokenrange)
-      tables->tokenrange = TKNCOUNT;
-#endif /* PARSER_STATS */
+   tables->failtable[reuse] = *failure;
 }
 
 
@@ -1520,39 +3607,29 @@ static void write_line
 {
 /* Skip over or write the line beginning at tables->unwritten */
 
-   location	nextline;	/* Start of next line or EOF */
-   location	where;		/* Current position in line */
-   int		ch;		/* Current input character */
-   int		column;		/* Current column in line */
-   bufferentry *buffer;		/* Temporary buffer pointer */
-   int		i;
+   location nextline;		/* Start of next line or EOF */
+   location where;		/* Current position in line */
+   int	    ch;			/* Current input character */
+   int	    column;		/* Current column in line */
+   int	    i;
 
 /* If unwritten is already at EOF, pretend the start of the */
 /* next line is EOF+1 otherwise search for newline or EOF   */
 
+   if (tables->unwritten.offset >= tables->unwritten.buffer->count)
+      read_buffer(tables, &tables->unwritten);
+
    nextline = tables->unwritten;
    if (nextline.offset >= nextline.buffer->count)
       nextline.offset = nextline.buffer->count + 1;
    else
-      for (;;)
-      {
-	 if (nextline.offset >= nextline.buffer->count && !read_buffer(tables, &nextline))
-	    break;
-	 if (nextline.buffer->buffer[nextline.offset++] == '\n')
-	 {
-	    if (nextline.offset >= nextline.buffer->count)
-	       read_buffer(tables, &nextline);
-	    break;
-	 }
-      }
+      find_newline(tables, &nextline, NULL);
 
    tables->lineno++;
 
 /* If a listing was requested or this line contains an error, print it */
 
-   if (tables->listing || MSGCOUNT &&
-      (MSGQUEUE(0).point.buffer->order < nextline.buffer->order ||
-       MSGQUEUE(0).point.buffer == nextline.buffer && MSGQUEUE(0).point.offset < nextline.offset))
+   if (tables->listing || MSGCOUNT && POSITION(MSGQUEUE(0).point) < POSITION(nextline))
    {
 /*    If the last displayed line included at least one error message skip a line  */
 
@@ -1570,7 +3647,7 @@ static void write_line
 
 	 printf("%6d: ", tables->lineno);
 
-	 while (where.buffer->order < nextline.buffer->order || where.buffer == nextline.buffer && where.offset < nextline.offset)
+	 while (POSITION(where) < POSITION(nextline))
 	 {
 	    ch = where.buffer->buffer[where.offset++];
 	    if (where.offset >= where.buffer->count && where.buffer->next)
@@ -1602,13 +3679,11 @@ static void write_line
 
       where  = tables->unwritten;
       column = 0;
-      while (MSGCOUNT && (MSGQUEUE(0).point.buffer->order < nextline.buffer->order ||
-	     MSGQUEUE(0).point.buffer == nextline.buffer && MSGQUEUE(0).point.offset < nextline.offset))
+      while (MSGCOUNT && POSITION(MSGQUEUE(0).point) < POSITION(nextline))
       {
 /*	 Calculate the column of the error message */
 
-	 while (where.buffer->order < MSGQUEUE(0).point.buffer->order ||
-		where.buffer == MSGQUEUE(0).point.buffer && where.offset < MSGQUEUE(0).point.offset)
+	 while (POSITION(where) < POSITION(MSGQUEUE(0).point))
 	 {
 	    column += char_width(where.buffer->buffer[where.offset++], RAW_CHAR, column);
 	    if (where.offset >= where.buffer->count && where.buffer->next)
@@ -1640,7 +3715,7 @@ static void write_line
 		  where.offset = 0;
 	       }
 
-	       if (where.offset > MSGQUEUE(0).last.offset || where.buffer->order > MSGQUEUE(0).last.buffer->order)
+	       if (POSITION(where) > POSITION(MSGQUEUE(0).last))
 		  break;
 	    }
 	    fputc('\n', stdout);
@@ -1654,26 +3729,13 @@ static void write_line
 
 /*	 And remove the error from the queue */
 
-	 if (--MSGCOUNT)
-	    memmove(&MSGQUEUE(0), &MSGQUEUE(1), MSGCOUNT * MSGELEMENT);
+	 dynrotate(&tables->msgqueue, 1);
       }
    }
 
-/* Move unwritten ahead one line */
+/* Move unwritten ahead one line and release the buffers before it */
 
    tables->unwritten = nextline;
-
-/* Any input buffers that precede the first unwritten line are no longer needed */
-
-   while (tables->bufferlist != tables->unwritten.buffer)
-   {
-      buffer             = tables->bufferlist;
-      tables->bufferlist = tables->bufferlist->next;
-
-      free(buffer);
-
-#ifdef	  PARSER_STATS
-      tables->buffercount--;
-#endif /* PARSER_STATS */
-   }
+   tables->lineend   = nextline;
+   drop_buffers(tables);
 }
@@ -57,6 +57,49 @@ int char_width
 }
 
 
+int decode_utf8
+(
+   unsigned char **string
+)
+{
+/* Return the code point encoded in UTF-8 at the start of a string and  */
+/* step past it.  A byte which does not start a valid encoding stands	*/
+/* for itself								*/
+
+   unsigned char *p;
+   int		  code;
+   int		  length;
+   int		  i;
+
+   p = *string;
+   if (*p < 0xC2 || *p > 0xF4)
+      length = 1;
+   else if (*p < 0xE0)
+      length = 2;
+   else if (*p < 0xF0)
+      length = 3;
+   else
+      length = 4;
+
+   if (length > 1)
+   {
+      code = *p & (0x3F >> (length - 1));
+      for (i = 1; i < length && (p[i] & 0xC0) == 0x80; i++)
+	 code = code << 6 | p[i] & 0x3F;
+
+/*    Reject a truncated, overlong, surrogate, or out of range encoding */
+
+      if (i == length && (length < 3 || code > 0x7FF) && (length < 4 || code > 0xFFFF) &&
+	  code <= 0x10FFFF && (code < 0xD800 || code > 0xDFFF))
+      {
+	 *string += length;
+	 return(code);
+      }
+   }
+   return(*(*string)++);
+}
+
+
 void display_char
 (
    int	 ch,
@@ -101,6 +144,66 @@ void display_char
 }
 
 
+int encode_utf8
+(
+   int		  code,
+   unsigned char *string
+)
+{
+/* Store the UTF-8 encoding of a code point and return its length */
+
+   if (code < 0x80)
+   {
+      string[0] = code;
+      return(1);
+   }
+   else if (code < 0x800)
+   {
+      string[0] = 0xC0 | code >> 6;
+      string[1] = 0x80 | code & 0x3F;
+      return(2);
+   }
+   else if (code < 0x10000)
+   {
+      string[0] = 0xE0 | code >> 12;
+      string[1] = 0x80 | code >> 6 & 0x3F;
+      string[2] = 0x80 | code & 0x3F;
+      return(3);
+   }
+   else
+   {
+      string[0] = 0xF0 | code >> 18;
+      string[1] = 0x80 | code >> 12 & 0x3F;
+      string[2] = 0x80 | code >> 6 & 0x3F;
+      string[3] = 0x80 | code & 0x3F;
+      return(4);
+   }
+}
+
+
+unsigned int hash_keyword
+(
+   unsigned int seed,
+   unsigned char *string,
+   int length
+)
+{
+/* Hash a keyword ignoring case with a seed for perfect hashing */
+
+   uint32_t value;			/* Accumulated integer value of keyword */
+
+   for (value = 0x811c9dc5L ^ (seed * 0x9e3779b9L); length > 0; string++, length--)
+   {
+      value ^= tolower(*string);
+      value *= 0x01000193L;
+   }
+   value ^= value >> 16;		/* Mix high bits down so modulus uses them */
+   value *= 0x85ebca6bL;
+   value ^= value >> 13;
+   return(value);
+}
+
+
 int hash_string
 (
    unsigned char *string
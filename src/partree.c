@@ -31,6 +31,7 @@
 #include "utility_functions.h"
 
 
+static void display_codes(unsigned char *, FILE *);
 static void list_tree(sdt_tables *, treenode *, int, FILE *);
 
 
@@ -91,6 +92,7 @@ treenode *copy_tree
 
 	    case CHARACTER:
 	    case CLASS:
+	    case UNICLASS:
 	       if (!(string = strdup(tree->leaf.value.value)))
 		  out_of_memory();
 	       return(create_leaf(tree->leaf.type, string));
@@ -179,6 +181,7 @@ treenode *create_leaf
 
       case CHARACTER:
       case CLASS:
+      case UNICLASS:
 	 node->leaf.value.value = va_arg(args, unsigned char *);
 	 break;
 
@@ -246,6 +249,25 @@ treenode *create_unary
 }
 
 
+static void display_codes
+(
+   unsigned char *string,
+   FILE		 *fp
+)
+{
+/* Display the code points of a Unicode class, giving those past ASCII	*/
+/* as the escapes they were written with				*/
+
+   int code;
+
+   while (*string)
+      if ((code = decode_utf8(&string)) < 0x80)
+	 display_char(code, CLASS_CHAR, fp);
+      else
+	 fprintf(fp, (code > 0xFFFF) ? "\\U%.6X" : "\\u%.4X", code);
+}
+
+
 void display_expression
 (
    sdt_tables *tables,
@@ -294,6 +316,12 @@ void display_expression
 	       fputc(']', fp);
 	    break;
 
+	 case UNICLASS:
+	    fputc('[', fp);
+	    display_codes(tree->leaf.value.value, fp);
+	    fputc(']', fp);
+	    break;
+
 	 case SEMANTIC:
 	    fprintf(fp, "@%d", tree->leaf.value.number);
 	    break;
@@ -407,7 +435,7 @@ void free_tree
 	    free_tree(node);
 	 }
       else
-	 if (tree->node.count == LEAF && (tree->leaf.type == CHARACTER || tree->leaf.type == CLASS))
+	 if (tree->node.count == LEAF && (tree->leaf.type == CHARACTER || tree->leaf.type == CLASS || tree->leaf.type == UNICLASS))
 	    free(tree->leaf.value.value);
       free(tree);
    }
@@ -531,6 +559,12 @@ static void list_tree
 	       fputs("]\n", fp);
 	    break;
 
+	 case UNICLASS:
+	    fputc('[', fp);
+	    display_codes(tree->leaf.value.value, fp);
+	    fputs("]\n", fp);
+	    break;
+
 	 case ZEROBYTE:
 	    fputs("NUL\n", fp);
 	    break;
@@ -37,8 +37,8 @@
 
 
 static int	      char_type(treenode *, char *);
-static int	      decode_char(unsigned char **);
-static unsigned char *decode_string(unsigned char *);
+static int	      decode_char(unsigned char **, bool *);
+static unsigned char *decode_string(unsigned char *, bool *);
 static void	      parser_tokens(sdt_tables *, treenode *);
 static void	      scanner_tokens(sdt_tables *, treenode *);
 
@@ -122,8 +122,13 @@ static int char_type
 	 case CLASS:
 	    return(CHARACTER_CLASS);
 
+/*	 A Unicode class matches sequences of bytes */
+
+	 case UNICLASS:
+	    return(CHARACTER_STRING);
+
 	 case CHARACTER:
-	    string = decode_string(tree->leaf.value.value);
+	    string = decode_string(tree->leaf.value.value, NULL);
 	    if (string[0] && !string[1])
 	    {
 	       if (value)
@@ -144,32 +149,39 @@ static int char_type
 
 static int decode_char
 (
-   unsigned char **ccode
+   unsigned char **ccode,
+   bool		  *unicode
 )
 {
-/* Convert escape character codes into a character */
+/* Convert escape character codes into a character.  Unicode is set if	*/
+/* a \u or \U escape gave a Unicode code point rather than a byte	*/
 
    unsigned char *start;
    unsigned char *value;
    int		  chr;
    int		  digit;
+   int		  digits;
+   bool		  code;
    int		  i;
 
 /* Check for escape sequence or return character */
 
+   *unicode = false;
    if (**ccode != '\\')
       return(*(*ccode)++);
 
    start = *ccode + 1;
    value = start;
 
-/* Check for hexadecimal character code */
+/* Check for hexadecimal character code or code point */
 
-   chr = 0;
-   if (*value == 'x')
+   chr  = 0;
+   code = *value == 'u' || *value == 'U';
+   if (*value == 'x' || code)
    {
+      digits = (*value == 'x') ? 2 : (*value == 'u') ? 4 : 6;
       value++;
-      for (i = 0; i < 2; i++)
+      for (i = 0; i < digits; i++)
       {
               if (*value >= 'a' && *value <= 'f')
 	    digit = *value++ - 'a' + 10;
@@ -209,7 +221,16 @@ static int decode_char
 
 /* If the interpreted character code is valid, accept it */
 
-   if (chr > 0 && chr <= 0xFF)
+   if (code)
+   {
+      if (chr > 0 && chr <= 0x10FFFF && (chr < 0xD800 || chr > 0xDFFF))
+      {
+	 *unicode = true;
+	 *ccode   = value;
+	 return(chr);
+      }
+   }
+   else if (chr > 0 && chr <= 0xFF)
    {
       *ccode = value;
       return(chr);
@@ -266,26 +287,59 @@ static int decode_char
 
 static unsigned char *decode_string
 (
-   unsigned char *src
+   unsigned char *src,
+   bool		 *unicode
 )
 {
-/* Create copy of string with character codes decoded */
+/* Create copy of string with character codes decoded, and Unicode code	*/
+/* points encoded in UTF-8.  If unicode is given it is set when the	*/
+/* string contains a code point, either as an escape or already encoded	*/
 
    unsigned char *string;
    unsigned char *dst;
+   unsigned char *next;
+   bool		  code;
+   bool		  found;
    int		  c;
 
-/* The resulting string cannot be longer than the source */
+/* The resulting string cannot be longer than the source, since no  */
+/* UTF-8 encoding is longer than the escape it came from	    */
 
    if (!(string = malloc(strlen(src) + 1)))
       out_of_memory();
 
 /* Decode source to destination and return it */
 
-   dst = string;
-   while (c = decode_char(&src))
-      *dst++ = c;
+   dst   = string;
+   found = false;
+   while (*src)
+   {
+/*    Copy a character already encoded in UTF-8 as it is */
+
+      next = src;
+      decode_utf8(&next);
+      if (next - src > 1)
+      {
+	 while (src < next)
+	    *dst++ = *src++;
+	 found = true;
+      }
+      else
+      {
+	 c = decode_char(&src, &code);
+	 if (code)
+	 {
+	    dst   += encode_utf8(c, dst);
+	    found  = true;
+	 }
+	 else
+	    *dst++ = c;
+      }
+   }
    *dst = '\0';
+
+   if (unicode)
+      *unicode = found;
    return(string);
 }
 
@@ -454,6 +508,8 @@ void perform_action
    int		range[2];
    treenode    *node;
    treenode    *tree;
+   unsigned char *string;
+   bool		unicode;
    int		type1;
    int		type2;
    char		lower;
@@ -565,6 +621,8 @@ void perform_action
 	       tables->options |= AMBIGUOUS;
 	    else if (!strcasecmp(PARSTACK(PARCOUNT - 1).symbol, "ERRORREPAIR"))
 	       tables->options |= ERRORREPAIR;
+	    else if (!strcasecmp(PARSTACK(PARCOUNT - 1).symbol, "KEYWORDS"))
+	       tables->options |= KEYWORDS;
 	    else if (!strcasecmp(PARSTACK(PARCOUNT - 1).symbol, "SHIFTREDUCE"))
 	       tables->options |= DEFAULTREDUCE;
 	    else if (!strcasecmp(PARSTACK(PARCOUNT - 1).symbol, "SPLITSTATES"))
@@ -750,7 +808,7 @@ void perform_action
 
 	       (symbol1 = lookup_symbol(tables, &PARSTACK(PARCOUNT - 3).symbol[1], TERMINAL, INSERT))->value.value = tables->tokenval;
 	       dyncheck(&tables->semstack, SEMSIZE * 2);
-	       SEMSTACK(SEMCOUNT++) = create_binary('.', create_leaf(CHARACTER, decode_string(&PARSTACK(PARCOUNT - 3).symbol[1])), create_leaf(REFERENCE, symbol1));
+	       SEMSTACK(SEMCOUNT++) = create_binary('.', create_leaf(CHARACTER, decode_string(&PARSTACK(PARCOUNT - 3).symbol[1], NULL)), create_leaf(REFERENCE, symbol1));
 	    }
 	    else
 	       record_error(tables, &PARSTACK(PARCOUNT - 1).where, "%s", "Duplicate token definition ignored");
@@ -1077,7 +1135,7 @@ void perform_action
 	       PARSTACK(PARCOUNT - 1).symbol[length1 - 1] = '\0';
 
 	 dyncheck(&tables->semstack, SEMSIZE * 2);
-	 SEMSTACK(SEMCOUNT++) = (length1 >= 3) ? create_leaf(CHARACTER, decode_string(&PARSTACK(PARCOUNT - 1).symbol[1])) : create_leaf(EPSILON);
+	 SEMSTACK(SEMCOUNT++) = (length1 >= 3) ? create_leaf(CHARACTER, decode_string(&PARSTACK(PARCOUNT - 1).symbol[1], NULL)) : create_leaf(EPSILON);
 	 break;
 
       case 28:		/* Create transition for a character class */
@@ -1087,8 +1145,16 @@ void perform_action
 	    else
 	       PARSTACK(PARCOUNT - 1).symbol[length1 - 1] = '\0';
 
+/*	 A class containing a code point is a class of Unicode code points */
+
 	 dyncheck(&tables->semstack, SEMSIZE * 2);
-	 SEMSTACK(SEMCOUNT++) = (length1 >= 3) ? create_leaf(CLASS, decode_string(&PARSTACK(PARCOUNT - 1).symbol[1])) : create_leaf(EPSILON);
+	 if (length1 >= 3)
+	 {
+	    string = decode_string(&PARSTACK(PARCOUNT - 1).symbol[1], &unicode);
+	    SEMSTACK(SEMCOUNT++) = create_leaf((unicode) ? UNICLASS : CLASS, string);
+	 }
+	 else
+	    SEMSTACK(SEMCOUNT++) = create_leaf(EPSILON);
 	 break;
 
       case 29:		/* Create a lookahead expression */
@@ -37,9 +37,14 @@
 #include "utility_functions.h"
 
 
+static bool assign_slots(sdt_tables *, int, int *);
 static int  bitmap_size(unsigned char [MAPSIZE]);
+static void build_classes(sdt_tables *);
 static void build_dfa(sdt_tables *, intset *);
 static void build_nfa(sdt_tables *, treenode *, bool, bool *, intset *, intset *);
+static int  build_sequence(sdt_tables *, int, int, intset *, intset *);
+static int  build_unicode(sdt_tables *, unsigned char *, intset *, intset *);
+static void check_keywords(sdt_tables *, intset *);
 static void cleanup_tokens(sdt_tables *);
 static bool compatible(sdt_tables *, dfastate *, dfastate *);
 static int  count_positions(treenode *);
@@ -49,12 +54,88 @@ static void display_dfa(sdt_tables *, char *, FILE *);
 static void display_nfa(sdt_tables *, intset *, FILE *);
 static void display_terminals(sdt_tables *, FILE *);
 static bool expand_class(unsigned char *, unsigned char *);
+static void expand_unicode(unsigned char *, unsigned char *);
+static void follow_states(sdt_tables *, intset *, int, intset *);
 static void free_automaton(sdt_tables *);
 static void free_positions(sdt_tables *);
 static void list_tokens(sdt_tables *, treenode *, int, int, bool, FILE *);
 static void list_values(sdt_tables *, symbolentry *, int, int, treenode *, int, FILE *);
 static int  lookup_state(sdt_tables *, intset *);
+static void mark_keywords(sdt_tables *);
+static int  match_keyword(sdt_tables *, intset *, symbolentry *);
 static void minimize_dfa(sdt_tables *);
+static void write_values(int *, int, FILE *);
+
+
+static bool assign_slots
+(
+   sdt_tables *tables,
+   int	       buckets,
+   int	      *seed
+)
+{
+/* Spread the keywords over buckets first level hash buckets and, */
+/* starting with the largest bucket, find a seed for each bucket  */
+/* which puts all its keywords into slots not yet taken		  */
+
+   char *taken;
+   int	*size;
+   int	 most;
+   int	 slot;
+   int	 b, i, j;
+
+   if (!(taken = (char *) calloc(KEYCOUNT, sizeof(*taken))) || !(size = (int *) calloc(buckets, sizeof(*size))))
+      out_of_memory();
+
+   for (most = 0, i = 0; i < KEYCOUNT; i++)
+   {
+      b = KEYTOKEN(i).bucket = hash_keyword(0, KEYTOKEN(i).symbol->symbol, strlen(KEYTOKEN(i).symbol->symbol)) % buckets;
+      if (++size[b] > most)
+	 most = size[b];
+   }
+
+   for (b = 0; b < buckets; b++)
+      seed[b] = 0;
+
+   for (; most > 0; most--)
+      for (b = 0; b < buckets; b++)
+	 if (size[b] == most)
+	 {
+	    for (seed[b] = 1; seed[b] < MAXKEYSEED; seed[b]++)
+	    {
+/*	       Take the slot of each keyword in the bucket until one is already taken */
+
+	       for (i = 0; i < KEYCOUNT; i++)
+		  if (KEYTOKEN(i).bucket == b)
+		  {
+		     slot = hash_keyword(seed[b], KEYTOKEN(i).symbol->symbol, strlen(KEYTOKEN(i).symbol->symbol)) % KEYCOUNT;
+		     if (taken[slot])
+			break;
+		     taken[slot] = true;
+		     KEYTOKEN(i).slot = slot;
+		  }
+	       if (i == KEYCOUNT)
+		  break;
+
+/*	       Give back the slots taken with this seed and try the next */
+
+	       for (j = 0; j < i; j++)
+		  if (KEYTOKEN(j).bucket == b)
+		     taken[KEYTOKEN(j).slot] = false;
+	    }
+
+	    if (seed[b] == MAXKEYSEED)
+	    {
+	       free(taken);
+	       free(size);
+	       return(false);
+	    }
+	 }
+
+   free(taken);
+   free(size);
+   return(true);
+}
 
 
 static int bitmap_size
@@ -104,6 +185,56 @@ static int bitmap_size
 }
 
 
+static void build_classes
+(
+   sdt_tables *tables
+)
+{
+/* Partition the input characters into equivalence classes.  Two     */
+/* characters are equivalent if every NFA position transitions on    */
+/* both or on neither of them, so the DFA only needs transitions for */
+/* one representative character from each class			     */
+
+   int split[2 * MAPCOUNT];	/* New class number for each old class */
+   int count;
+   int i, j;
+
+   if (!(tables->charclass = (int *) malloc(MAPCOUNT * sizeof(*tables->charclass))))
+      out_of_memory();
+
+/* Start with every character in one class and refine it by each position */
+
+   memset(tables->charclass, 0, MAPCOUNT * sizeof(*tables->charclass));
+   tables->classcount = 1;
+   for (i = 1; i < NFACOUNT; i++)
+   {
+/*    Move the characters in this position's bitmap out of their classes */
+
+      for (j = 0; j < tables->classcount; j++)
+	 split[j] = -1;
+      for (count = tables->classcount, j = 0; j <= ENDFILE; j++)
+	 if (BITTST(NFAPOSITION(i).bitmap, j))
+	 {
+	    if (split[tables->charclass[j]] < 0)
+	       split[tables->charclass[j]] = count++;
+	    tables->charclass[j] = split[tables->charclass[j]];
+	 }
+
+/*    Renumber the classes in order of their first character to close the gaps */
+
+      for (j = 0; j < count; j++)
+	 split[j] = -1;
+      for (count = j = 0; j <= ENDFILE; j++)
+      {
+	 if (split[tables->charclass[j]] < 0)
+	    split[tables->charclass[j]] = count++;
+	 tables->charclass[j] = split[tables->charclass[j]];
+      }
+      tables->classcount = count;
+   }
+}
+
+
 static void build_dfa
 (
    sdt_tables *tables,
@@ -114,21 +245,27 @@ static void build_dfa
    int	      input;
    intset     merge;
    transition action[MAPCOUNT];
+   int	      member[MAPCOUNT];
    int	      i, j, k;
 
    if (INTCOUNT(*first))
    {
+/*    Find the first character of each class to represent the class */
+
+      for (i = ENDFILE; i >= 0; i--)
+	 member[tables->charclass[i]] = i;
+
       for (i = lookup_state(tables, first); i < DFACOUNT; i++)
       {
-	 for (count = 0, input = 0; input <= ENDFILE; input++)
+	 for (count = 0, input = 0; input < tables->classcount; input++)
 	 {
-/*	    Union all the states that this state transitions to on input character */
+/*	    Union all the states that this state transitions to on input class */
 
 	    for (INTCOUNT(*first) = 0, j = 0; j < INTCOUNT(DFASTATE(i).states); j++)
 	    {
 	       k = INTSET(DFASTATE(i).states, j);
 
-	       if (BITTST(NFAPOSITION(k).bitmap, input))
+	       if (BITTST(NFAPOSITION(k).bitmap, member[input]))
 	       {
 		  intset_union(&merge, first, &NFAPOSITION(k).follow);
 		  intset_free(first);
@@ -205,7 +342,7 @@ static void build_nfa
    bool	     null;
    intset    merge;
    int	     length;
-   char	     c;
+   int	     c;
    int	     i, j;
 
    intset_alloc(&first, INITIAL_NFASET_SIZE);
@@ -218,9 +355,15 @@ static void build_nfa
 	 case '.':
 
 /*	    Check the last node in the concatenation for a token definition */
-/*	    and if it was found check if it specifies case insignificance   */
+/*	    and if it was found check if it specifies case insignificance.  */
+/*	    Keywords found by lookup are left out of the NFA entirely	    */
 
 	    node = tree->node.entry[3];
+	    if (node->node.count == LEAF && node->leaf.type == REFERENCE && (node->leaf.value.symbol->value.value.flags & KEYWORD))
+	    {
+	       *nullable = false;
+	       break;
+	    }
 	    both = node->node.count == LEAF && node->leaf.type == REFERENCE && (node->leaf.value.symbol->value.value.flags & CASE);
 
 /*	    Remember the size of the NFA before building this token */
@@ -293,6 +436,7 @@ static void build_nfa
 
 		     intset_free(&token);
 		     intset_copy(&token, lastpos);
+		     tables->lookaheads++;
 		  }
 		  else
 		     if (NFACOUNT > start)
@@ -438,6 +582,13 @@ static void build_nfa
 	    NFACOUNT++;
 	    break;
 
+	 case UNICLASS:
+
+/*	    Create the byte sequences of a class of Unicode code points */
+
+	    *nullable = !build_unicode(tables, tree->leaf.value.value, firstpos, lastpos);
+	    break;
+
 	 case EPSILON:
 	    *nullable = true;
 	    break;
@@ -452,6 +603,192 @@ static void build_nfa
 }
 
 
+static int build_sequence
+(
+   sdt_tables *tables,
+   int	       low,
+   int	       high,
+   intset     *firstpos,
+   intset     *lastpos
+)
+{
+/* Build positions matching the UTF-8 encoding of the code points from	*/
+/* low to high, all of which lie outside ASCII, and return how many	*/
+/* there are.  The range is split until each byte of the encodings	*/
+/* ranges independently of the others, when a chain of positions, one	*/
+/* per byte, matches the range.  Without tables they are only counted	*/
+
+   static const int limit[] = {0x7FF, 0xFFFF};	/* Largest code point of each encoded length */
+
+   unsigned char lowbytes[4];		/* Encoding of low */
+   unsigned char highbytes[4];		/* Encoding of high */
+   int		 length;		/* Length of the encodings */
+   int		 mask;			/* Code point bits in the trailing bytes */
+   int		 c;
+   int		 i;
+
+/* Split a range whose ends have encodings of different lengths */
+
+   for (i = 0; i < sizeof(limit) / sizeof(*limit); i++)
+      if (low <= limit[i] && high > limit[i])
+	 return(build_sequence(tables, low, limit[i], firstpos, lastpos) + build_sequence(tables, limit[i] + 1, high, firstpos, lastpos));
+
+/* Split a range whose ends differ before the trailing bytes unless */
+/* those bytes run all the way from 0x80 to 0xBF		    */
+
+   length = encode_utf8(low, lowbytes);
+   encode_utf8(high, highbytes);
+   for (i = 1; i < length; i++)
+   {
+      mask = (1 << 6 * i) - 1;
+      if ((low & ~mask) != (high & ~mask))
+	 if (low & mask)
+	    return(build_sequence(tables, low, low | mask, firstpos, lastpos) + build_sequence(tables, (low | mask) + 1, high, firstpos, lastpos));
+	 else if ((high & mask) != mask)
+	    return(build_sequence(tables, low, (high & ~mask) - 1, firstpos, lastpos) + build_sequence(tables, high & ~mask, high, firstpos, lastpos));
+   }
+
+/* Chain a position for each byte of the encodings */
+
+   if (tables)
+   {
+      intset_insert(firstpos, NFACOUNT);
+      for (i = 0; i < length; i++)
+      {
+	 for (c = lowbytes[i]; c <= highbytes[i]; c++)
+	    BITSET(NFAPOSITION(NFACOUNT).bitmap, c);
+
+	 intset_alloc(&NFAPOSITION(NFACOUNT).follow, INITIAL_NFASET_SIZE);
+	 if (i < length - 1)
+	    intset_insert(&NFAPOSITION(NFACOUNT).follow, NFACOUNT + 1);
+	 NFACOUNT++;
+      }
+      intset_insert(lastpos, NFACOUNT - 1);
+   }
+   return(length);
+}
+
+
+static int build_unicode
+(
+   sdt_tables	 *tables,
+   unsigned char *class,
+   intset	 *firstpos,
+   intset	 *lastpos
+)
+{
+/* Build positions matching the UTF-8 encoding of every code point in a	*/
+/* Unicode class and return how many there are.  The ASCII code points	*/
+/* share a single position, and every other range of code points in the	*/
+/* class gets byte sequences of its own.  Without tables the positions	*/
+/* are only counted							*/
+
+   unsigned char *points;		/* Bitmap of the class's code points */
+   int		  count;		/* Number of positions */
+   int		  low;			/* First code point of a range */
+   int		  high;			/* Code point following the range */
+
+   if (!(points = malloc(UNICODESIZE)))
+      out_of_memory();
+   expand_unicode(points, class);
+
+/* Gather the ASCII code points into one position */
+
+   for (count = 0, low = 0; low < 0x80; low++)
+      if (BITTST(points, low))
+      {
+	 if (tables)
+	 {
+	    if (!count)
+	    {
+	       intset_insert(firstpos, NFACOUNT);
+	       intset_insert(lastpos, NFACOUNT);
+	       intset_alloc(&NFAPOSITION(NFACOUNT).follow, INITIAL_NFASET_SIZE);
+	       NFACOUNT++;
+	    }
+	    BITSET(NFAPOSITION(NFACOUNT - 1).bitmap, low);
+	 }
+	 count = 1;
+      }
+
+/* And build the byte sequences for each range of the others */
+
+   for (low = 0x80; low < UNICODECOUNT; low = high)
+      if (!BITTST(points, low))
+	 high = low + 1;
+      else
+      {
+	 for (high = low + 1; high < UNICODECOUNT && BITTST(points, high); high++)
+	    ;
+	 count += build_sequence(tables, low, high - 1, firstpos, lastpos);
+      }
+
+   free(points);
+   return(count);
+}
+
+
+static void check_keywords
+(
+   sdt_tables *tables,
+   intset     *firstpos
+)
+{
+/* Find the token the scanner returns in place of each keyword left out */
+/* of the NFA.  Keywords which the scanner could not return that way,   */
+/* or which differ only in case from another keyword, are put back	*/
+
+   treenode    *node;
+   symbolentry *symbol;
+   intset	first;
+   intset	last;
+   intset	merge;
+   bool		null;
+   int		count;
+   int		i, j;
+
+/* Find the base token of every keyword candidate */
+
+   for (KEYCOUNT = 0, node = tables->scanner->node.entry[0]; node; node = node->node.next)
+      if (node->node.count != LEAF && node->node.type == '.' && node->node.entry[3]->node.count == LEAF &&
+	  node->node.entry[3]->leaf.type == REFERENCE && ((symbol = node->node.entry[3]->leaf.value.symbol)->value.value.flags & KEYWORD))
+      {
+	 dyncheck(&tables->keywordlist, KEYSIZE * 2);
+	 KEYTOKEN(KEYCOUNT  ).symbol = symbol;
+	 KEYTOKEN(KEYCOUNT  ).tree   = node;
+	 KEYTOKEN(KEYCOUNT++).base   = match_keyword(tables, firstpos, symbol);
+      }
+
+/* The keyword hash ignores case so every keyword must differ in more than case */
+
+   for (i = 0; i < KEYCOUNT; i++)
+      for (j = i + 1; j < KEYCOUNT; j++)
+	 if (!strcasecmp(KEYTOKEN(i).symbol->symbol, KEYTOKEN(j).symbol->symbol))
+	    KEYTOKEN(i).base = KEYTOKEN(j).base = 0;
+
+/* Keep the keywords that have a base token and build the rest into the NFA */
+
+   intset_alloc(&first, INITIAL_NFASET_SIZE);
+   intset_alloc(&last, INITIAL_NFASET_SIZE);
+   for (count = i = 0; i < KEYCOUNT; i++)
+      if (KEYTOKEN(i).base)
+	 KEYTOKEN(count++) = KEYTOKEN(i);
+      else
+      {
+	 KEYTOKEN(i).symbol->value.value.flags &= ~KEYWORD;
+	 build_nfa(tables, KEYTOKEN(i).tree, false, &null, &first, &last);
+	 intset_union(&merge, firstpos, &first);
+	 intset_free(firstpos);
+	 *firstpos = merge;
+	 INTCOUNT(first) = 0;
+	 INTCOUNT(last)  = 0;
+      }
+   KEYCOUNT = count;
+   intset_free(&first);
+   intset_free(&last);
+}
+
+
 static void cleanup_tokens
 (
    sdt_tables *tables
@@ -549,6 +886,10 @@ static int count_positions
 
 	 case CHARACTER:
 	    count = strlen(tree->leaf.value.value);
+	    break;
+
+	 case UNICLASS:
+	    count = build_unicode(NULL, tree->leaf.value.value, NULL, NULL);
       }
    return((count <= INT_MAX) ? (int) count : INT_MAX);
 }
@@ -757,13 +1098,16 @@ static void display_dfa
 {
 /* Display active states in the deterministic finite state automaton */
 
-   int width1;
-   int width2;
-   int width3;
-   int size;
-   int first;
-   int last;
-   int i, j;
+   int	      width1;
+   int	      width2;
+   int	      width3;
+   int	      size;
+   int	      first;
+   int	      last;
+   int	      next[MAPCOUNT];
+   transition action[MAPCOUNT];
+   int	      count;
+   int	      i, j;
 
 /* Determine the maximum size of various fields so they can be lined up */
 
@@ -796,33 +1140,45 @@ static void display_dfa
 	 if ((size = intset_size(&DFASTATE(i).tokens)) < width2)
 	    fprintf(fp, "%*s", width2 - size, " ");
 	 fprintf(fp, " %*d [", width3, DFASTATE(i).final);
-	 if (DFASTATE(i).count)
+
+/*	 Expand the class transitions back into character transitions for display */
+
+	 memset(next, 0, tables->classcount * sizeof(*next));
+	 for (j = 0; j < DFASTATE(i).count; j++)
+	    next[DFASTATE(i).action[j].index] = DFASTATE(i).action[j].state;
+	 for (count = j = 0; j <= ENDFILE; j++)
+	    if (next[tables->charclass[j]])
+	    {
+	       action[count  ].index = j;
+	       action[count++].state = next[tables->charclass[j]];
+	    }
+	 if (count)
 	 {
-	    for (first = last = 0, j = 1; j < DFASTATE(i).count; j++)
+	    for (first = last = 0, j = 1; j < count; j++)
 	    {
-	       if (DFASTATE(i).action[j].index != DFASTATE(i).action[last].index + 1 || DFASTATE(i).action[j].state != DFASTATE(i).action[last].state)
+	       if (action[j].index != action[last].index + 1 || action[j].state != action[last].state)
 	       {
-		  display_char(DFASTATE(i).action[first].index, CLASS_CHAR, fp);
+		  display_char(action[first].index, CLASS_CHAR, fp);
 		  if (first < last)
 		  {
 		     fputc('-', fp);
-		     display_char(DFASTATE(i).action[last].index, CLASS_CHAR, fp);
+		     display_char(action[last].index, CLASS_CHAR, fp);
 		  }
-		  fprintf(fp, "=%d", DFASTATE(DFASTATE(i).action[last].state).index);
-		  if (j < DFASTATE(i).count)
+		  fprintf(fp, "=%d", DFASTATE(action[last].state).index);
+		  if (j < count)
 		     fputc(' ', fp);
 		  first = j;
 	       }
 	       last = j;
 	    }
-	    display_char(DFASTATE(i).action[first].index, CLASS_CHAR, fp);
+	    display_char(action[first].index, CLASS_CHAR, fp);
 	    if (first < last)
 	    {
 	       fputc('-', fp);
-	       display_char(DFASTATE(i).action[last].index, CLASS_CHAR, fp);
+	       display_char(action[last].index, CLASS_CHAR, fp);
 	    }
-	    fprintf(fp, "=%d", DFASTATE(DFASTATE(i).action[last].state).index);
-	    if (j < DFASTATE(i).count - 1)
+	    fprintf(fp, "=%d", DFASTATE(action[last].state).index);
+	    if (j < count - 1)
 	       fputc(' ', fp);
 	 }
 	 fputs("]\n", fp);
@@ -1033,6 +1389,107 @@ static bool expand_class
 }
 
 
+static void expand_unicode
+(
+   unsigned char *points,
+   unsigned char *class
+)
+{
+/* Convert a Unicode class, whose code points are encoded in UTF-8, into */
+/* a bitmap of code points the way expand_class does for bytes.  The	 */
+/* surrogates used by UTF-16 are never part of a class			 */
+
+   unsigned char *p;
+   bool		  invert;
+   int		  c;
+   int		  high;
+   bool		  dup;
+   int		  i;
+
+   memset(points, 0, UNICODESIZE);
+   p = class;
+
+/* Check for negated class */
+
+   if (*p == '^')
+   {
+      invert = true;
+      p++;
+   }
+   else
+      invert = false;
+
+/* Process the remaining code points in the class */
+
+   c   = -1;
+   dup = false;
+   while (*p)
+   {
+/*    If there are both a previous and next code point this is a range */
+
+      if (*p == '-' && c >= 0 && *(p + 1))
+      {
+	 p++;
+	 if (c <= (high = decode_utf8(&p)))
+
+/*	    The range is non-empty so fill it in */
+
+	    for (i = c + 1; i <= high; i++)
+	       BITSET(points, i);
+	 else
+
+/*	    The range is empty so remove the value we erroneously added */
+
+	    if (!dup)
+	       BITCLR(points, c);
+	 c   = -1;
+	 dup = false;
+      }
+      else
+      {
+/*	 Add normal code point, or just a dash, to class */
+
+	 c   = decode_utf8(&p);
+	 dup = BITTST(points, c) != 0;
+	 BITSET(points, c);
+      }
+   }
+
+/* If class is inverted invert all the bytes in the bitmap */
+
+   if (invert)
+      for (i = 0; i < UNICODESIZE; i++)
+	 points[i] = ~points[i];
+
+   for (i = 0xD800; i <= 0xDFFF; i++)
+      BITCLR(points, i);
+}
+
+
+static void follow_states
+(
+   sdt_tables *tables,
+   intset     *states,
+   int	       input,
+   intset     *next
+)
+{
+/* Find the positions which follow any of states on the input character */
+
+   intset merge;
+   int	  i;
+
+   intset_alloc(next, INITIAL_NFASET_SIZE);
+   for (i = 0; i < INTCOUNT(*states); i++)
+      if (BITTST(NFAPOSITION(INTSET(*states, i)).bitmap, input))
+      {
+	 intset_union(&merge, next, &NFAPOSITION(INTSET(*states, i)).follow);
+	 intset_free(next);
+	 *next = merge;
+      }
+}
+
+
 static void free_automaton
 (
    sdt_tables *tables
@@ -1053,6 +1510,10 @@ static void free_automaton
 
    dynfree(&tables->dfastates);
    tables->dfacount = 0;
+
+   free(tables->charclass);
+   tables->charclass  = NULL;
+   tables->classcount = 0;
 }
 
 
@@ -1075,6 +1536,10 @@ static void free_positions
 
    for (i = 1; i < DFACOUNT; i++)
       intset_free(&DFASTATE(i).states);
+
+/* As well as the first positions kept for a lazily built DFA */
+
+   intset_free(&tables->nfastart);
 }
 
 
@@ -1087,6 +1552,7 @@ void free_scangen
 
    free_positions(tables);
    free_automaton(tables);
+   dynfree(&tables->keywordlist);
 }
 
 
@@ -1106,13 +1572,20 @@ void generate_scanner
    if (tables->display & DISPLAY_R)
       display_terminals(tables, stdout);
 
-/* Build positions corresponding to the important states of the NFA */
+/* Build positions corresponding to the important states of the NFA, */
+/* leaving out any keywords which are to be found by lookup	     */
+
+   if (tables->options & KEYWORDS)
+      mark_keywords(tables);
 
    intset_alloc(&firstpos, INITIAL_NFASET_SIZE);
    intset_alloc(&lastpos, INITIAL_NFASET_SIZE);
    build_nfa(tables, tables->scanner, false, &nullable, &firstpos, &lastpos);
    intset_free(&lastpos);
 
+   if (KEYCOUNT)
+      check_keywords(tables, &firstpos);
+
 /* We've created the NFA from the syntax tree so free the tree */
 
    free_tree(tables->scanner);
@@ -1123,10 +1596,24 @@ void generate_scanner
    if (tables->debug & DEBUG_N)
       display_nfa(tables, &firstpos, stdout);
 
-/* Now convert the NFA into a DFA */
+/* Reduce the input characters to equivalence classes and convert the NFA into a DFA */
+
+   build_classes(tables);
+
+/* The NFA is written in place of the DFA if the DFA is to be built lazily */
 
-   build_dfa(tables, &firstpos);
-   intset_free(&firstpos);
+   if (tables->lazy)
+   {
+      tables->nfastart = firstpos;
+      tables->dfacount = NFACOUNT - 1;
+      if (!INTCOUNT(firstpos))
+	 tables->termcount = 0;
+   }
+   else
+   {
+      build_dfa(tables, &firstpos);
+      intset_free(&firstpos);
+   }
 }
 
 
@@ -1149,8 +1636,14 @@ bool init_scangen
 
       dynalloc(&tables->dfastates, sizeof(dfastate), INITIAL_DFA_SIZE);
       memset(&DFASTATE(0), 0, INITIAL_DFA_SIZE * DFAELEMENT);
-      DFACOUNT         = 1;
-      tables->dfacount = 0;
+      DFACOUNT           = 1;
+      tables->dfacount   = 0;
+      tables->lookaheads = 0;
+
+/*    Keywords found by lookup are collected as the NFA is built */
+
+      dynalloc(&tables->keywordlist, sizeof(keytoken), INITIAL_KEYWORD_SIZE);
+      KEYCOUNT = 0;
       return(true);
    }
    else
@@ -1334,6 +1827,96 @@ static int lookup_state
 }
 
 
+static void mark_keywords
+(
+   sdt_tables *tables
+)
+{
+/* Mark every token defined by nothing but its own name as a keyword */
+/* candidate, as long as the name is printable and has no escapes    */
+
+   treenode	 *node;
+   symbolentry	 *symbol;
+   unsigned char *c;
+
+   if (tables->scanner->node.count != LEAF && tables->scanner->node.type == '|')
+      for (node = tables->scanner->node.entry[0]; node; node = node->node.next)
+	 if (node->node.count == BINARY && node->node.type == '.' &&
+	     node->node.entry[0]->node.count == LEAF && node->node.entry[0]->leaf.type == CHARACTER &&
+	     node->node.entry[1]->node.count == LEAF && node->node.entry[1]->leaf.type == REFERENCE)
+	 {
+	    symbol = node->node.entry[1]->leaf.value.symbol;
+	    if (symbol->value.value.token > 0 && symbol->value.value.token <= tables->termcount &&
+		!(symbol->value.value.flags & EMPTY) && *symbol->symbol && !strcmp(symbol->symbol, node->node.entry[0]->leaf.value.value))
+	    {
+	       for (c = symbol->symbol; isprint(*c) && *c != '\\'; c++)
+		  ;
+	       if (!*c)
+	       {
+		  symbol->value.value.flags |= KEYWORD;
+		  KEYCOUNT++;
+	       }
+	    }
+	 }
+}
+
+
+static int match_keyword
+(
+   sdt_tables  *tables,
+   intset      *firstpos,
+   symbolentry *symbol
+)
+{
+/* Run the NFA over the name of a keyword and return the token the  */
+/* scanner recognizes in its place, or 0 if that token can't be	    */
+/* replaced by the keyword.  A case insignificant keyword needs an  */
+/* NFA that treats both cases of each of its letters alike	    */
+
+   intset	  states;
+   intset	  next;
+   intset	  other;
+   bool		  fold;
+   unsigned char *c;
+   int		  base;
+   int		  i, k;
+
+   fold = symbol->value.value.flags & CASE;
+   intset_copy(&states, firstpos);
+   for (c = symbol->symbol; *c && INTCOUNT(states); c++)
+   {
+      follow_states(tables, &states, *c, &next);
+      if (fold && isalpha(*c))
+      {
+	 follow_states(tables, &states, islower(*c) ? toupper(*c) : tolower(*c), &other);
+	 if (!intset_equal(&next, &other))
+	    INTCOUNT(next) = 0;
+	 intset_free(&other);
+      }
+      intset_free(&states);
+      states = next;
+   }
+
+/* The scanner returns the lowest numbered token ending here */
+
+   for (base = 0, i = 0; i < INTCOUNT(states); i++)
+      if ((k = NFAPOSITION(INTSET(states, i)).final) && (!base || k < base))
+	 base = k;
+
+/* Which must not be a lookahead token, so that it ends where the keyword */
+/* would, and must come after the keyword, which would otherwise win	  */
+
+   for (i = 0; i < INTCOUNT(states); i++)
+      if (NFAPOSITION(INTSET(states, i)).final == base && NFAPOSITION(INTSET(states, i)).token == base)
+	 break;
+   if (i == INTCOUNT(states) || base <= symbol->value.value.token || base > tables->termcount)
+      base = 0;
+
+   intset_free(&states);
+   return(base);
+}
+
+
 static void minimize_dfa
 (
    sdt_tables *tables
@@ -1484,6 +2067,174 @@ static void minimize_dfa
 }
 
 
+void write_keywords
+(
+   sdt_tables *tables,
+   FILE	      *fp
+)
+{
+/* Write the minimal perfect hash table of the keywords found by lookup: */
+/* the seed of each first level bucket, then for each slot the keyword's */
+/* token, the token the scanner returns in its place, its install and	 */
+/* case insignificance flags, and the index of its name in a string	 */
+
+   int	*seed;
+   int	*values;
+   int	*order;
+   char *string;
+   int	 buckets;
+   int	 longest;
+   int	 size;
+   int	 i;
+
+   if (!KEYCOUNT)
+      return;
+
+/* Find a perfect hash with as few buckets as possible */
+
+   for (buckets = (KEYCOUNT + 1) / 2; ; buckets++)
+   {
+      if (!(seed = (int *) malloc(buckets * sizeof(*seed))))
+	 out_of_memory();
+      if (assign_slots(tables, buckets, seed))
+	 break;
+      free(seed);
+   }
+
+   if (!(values = (int *) malloc((KEYCOUNT + 1) * sizeof(*values))) || !(order = (int *) malloc(KEYCOUNT * sizeof(*order))))
+      out_of_memory();
+
+   for (longest = 0, i = 0; i < KEYCOUNT; i++)
+   {
+      order[KEYTOKEN(i).slot] = i;
+      if (strlen(KEYTOKEN(i).symbol->symbol) > longest)
+	 longest = strlen(KEYTOKEN(i).symbol->symbol);
+   }
+
+   fprintf(fp, "%d %d %d\n", KEYCOUNT, buckets, longest);
+   write_values(seed, buckets, fp);
+
+   for (i = 0; i < KEYCOUNT; i++)
+      values[i] = KEYTOKEN(order[i]).symbol->value.value.token;
+   write_values(values, KEYCOUNT, fp);
+
+   for (i = 0; i < KEYCOUNT; i++)
+      values[i] = KEYTOKEN(order[i]).base;
+   write_values(values, KEYCOUNT, fp);
+
+   for (i = 0; i < KEYCOUNT; i++)
+      values[i] = KEYTOKEN(order[i]).symbol->value.value.flags & INSTALL;
+   write_values(values, KEYCOUNT, fp);
+
+   for (i = 0; i < KEYCOUNT; i++)
+      values[i] = (KEYTOKEN(order[i]).symbol->value.value.flags & CASE) != 0;
+   write_values(values, KEYCOUNT, fp);
+
+/* Write the index of each keyword's name followed by the concatenated names */
+
+   for (size = 0, i = 0; i < KEYCOUNT; i++)
+   {
+      values[i] = size;
+      size += strlen(KEYTOKEN(order[i]).symbol->symbol);
+   }
+   values[KEYCOUNT] = size;
+   write_values(values, KEYCOUNT + 1, fp);
+
+   if (!(string = (char *) malloc(size + 1)))
+      out_of_memory();
+   for (i = 0; i < KEYCOUNT; i++)
+      strcpy(&string[values[i]], KEYTOKEN(order[i]).symbol->symbol);
+
+   fprintf(fp, "%d\n", MAXLINE);
+   for (i = 0; i < size; i += MAXLINE)
+      fprintf(fp, "%.*s\n", (size - i > MAXLINE) ? MAXLINE : size - i, &string[i]);
+
+   free(string);
+   free(order);
+   free(values);
+   free(seed);
+}
+
+
+void write_nfa
+(
+   sdt_tables *tables,
+   FILE	      *fp
+)
+{
+/* Write the NFA from which the parser builds the scanner DFA as the	*/
+/* input requires it.  The tables written are the equivalence class	*/
+/* of every input character, the first positions, the end of token,	*/
+/* final, and install values of each position, the classes on which	*/
+/* each position has a transition, and the follow set of each position	*/
+
+   int *values;
+   int	member[MAPCOUNT];
+   int	count;
+   int	i, j;
+
+   write_values(tables->charclass, MAPCOUNT, fp);
+
+   fprintf(fp, "%d\n", INTCOUNT(tables->nfastart));
+   write_values(&INTSET(tables->nfastart, 0), INTCOUNT(tables->nfastart), fp);
+
+/* Find the first character of each class to represent the class */
+
+   for (i = ENDFILE; i >= 0; i--)
+      member[tables->charclass[i]] = i;
+
+/* Count the transition classes and follow positions */
+
+   for (count = NFACOUNT, i = 1; i < NFACOUNT; i++)
+      count += tables->classcount + INTCOUNT(NFAPOSITION(i).follow);
+
+   if (!(values = (int *) malloc(count * sizeof(*values))))
+      out_of_memory();
+
+/* Write the end of token, final, and install values of each position */
+
+   for (i = 1; i < NFACOUNT; i++)
+      values[i - 1] = NFAPOSITION(i).token;
+   write_values(values, NFACOUNT - 1, fp);
+
+   for (i = 1; i < NFACOUNT; i++)
+      values[i - 1] = NFAPOSITION(i).final;
+   write_values(values, NFACOUNT - 1, fp);
+
+   for (i = 1; i < NFACOUNT; i++)
+      values[i - 1] = NFAPOSITION(i).install;
+   write_values(values, NFACOUNT - 1, fp);
+
+/* Write the index of each position's transition classes followed by */
+/* the concatenated classes					     */
+
+   for (count = 0, i = 1; i < NFACOUNT; i++)
+   {
+      values[i - 1] = count;
+      for (j = 0; j < tables->classcount; j++)
+	 if (BITTST(NFAPOSITION(i).bitmap, member[j]))
+	    values[NFACOUNT + count++] = j;
+   }
+   values[NFACOUNT - 1] = count;
+   write_values(values, NFACOUNT, fp);
+   write_values(&values[NFACOUNT], count, fp);
+
+/* And the index of each position's follow set followed by the sets */
+
+   for (count = 0, i = 1; i < NFACOUNT; i++)
+   {
+      values[i - 1] = count;
+      for (j = 0; j < INTCOUNT(NFAPOSITION(i).follow); j++)
+	 values[NFACOUNT + count++] = INTSET(NFAPOSITION(i).follow, j);
+   }
+   values[NFACOUNT - 1] = count;
+   write_values(values, NFACOUNT, fp);
+   write_values(&values[NFACOUNT], count, fp);
+
+   free(values);
+}
+
+
 void write_scanner
 (
    sdt_tables *tables,
@@ -1500,8 +2251,35 @@ void write_scanner
    int	width2;
    int *index;
    int *table;
+   bool loop[MAPCOUNT];
+   int	ranges;
+   int	first;
    int	i, j, k;
 
+/* Write the equivalence class of every input character */
+
+   width1 = digit_count(tables->classcount);
+   for (full = false, length = 0, i = 0; i <= ENDFILE; i++)
+   {
+      if (length + width1 > MAXLINE || full)
+      {
+	 fputc('\n', fp);
+	 full   = false;
+	 length = 0;
+      }
+      fprintf(fp, "%*d", width1, tables->charclass ? tables->charclass[i] : 0);
+      length += width1;
+      if (i < ENDFILE && length + 1 + width1 <= MAXLINE)
+      {
+	 fputc(' ', fp);
+	 length++;
+      }
+      else
+	 full = true;
+   }
+   if (length)
+      fputc('\n', fp);
+
 /* Count the number of important DFA states and the index of the last one */
 
    for (count = limit = 0, i = 1; i < DFACOUNT; i++)
@@ -1647,6 +2425,113 @@ void write_scanner
    if (length)
       fputc('\n', fp);
 
+/* Find the characters on which each state loops back to itself.  The   */
+/* scanner can skip over a run of them without interpreting the tables, */
+/* so record them for each state as at most MAXLOOPRANGES byte ranges   */
+
+   if ((index = (int *) malloc((limit + 1) * sizeof(*index))) && (table = (int *) malloc(limit * 2 * MAXLOOPRANGES * sizeof(*table))))
+   {
+      for (count = j = 0, i = 1; i < limit; i++)
+	 if (DFASTATE(i).index)
+	 {
+	    index[j++] = count;
+
+/*	    Mark the character classes which lead back to this state */
+
+	    memset(loop, false, sizeof(loop));
+	    for (k = 0; k < DFASTATE(i).count; k++)
+	       if (DFASTATE(i).action[k].state == i)
+		  loop[DFASTATE(i).action[k].index] = true;
+
+/*	    Collect the bytes in those classes into ranges */
+
+	    for (ranges = 0, first = -1, k = 0; k <= ENDFILE; k++)
+	       if (k < ENDFILE && loop[tables->charclass[k]])
+	       {
+		  if (first < 0)
+		     first = k;
+	       }
+	       else
+		  if (first >= 0)
+		  {
+		     if (ranges < MAXLOOPRANGES)
+		     {
+			table[count + 2 * ranges    ] = first;
+			table[count + 2 * ranges + 1] = k - 1;
+		     }
+		     ranges++;
+		     first = -1;
+		  }
+
+/*	    A state with too many ranges is left to the tables */
+
+	    if (ranges <= MAXLOOPRANGES)
+	       count += 2 * ranges;
+	 }
+      index[j++] = count;
+   }
+   else
+      out_of_memory();
+
+/* Write the loop range index table */
+
+   for (width1 = 0, i = 0; i < j; i++)
+      if (index[i] > width1)
+	 width1 = index[i];
+   width1 = digit_count(width1);
+
+   for (full = false, length = 0, i = 0; i < j; i++)
+   {
+      if (length + width1 > MAXLINE || full)
+      {
+	 fputc('\n', fp);
+	 full   = false;
+	 length = 0;
+      }
+      fprintf(fp, "%*d", width1, index[i]);
+      length += width1;
+      if (i < j - 1 && length + 1 + width1 <= MAXLINE)
+      {
+	 fputc(' ', fp);
+	 length++;
+      }
+      else
+	 full = true;
+   }
+   if (length)
+      fputc('\n', fp);
+
+/* Write the concatenated loop ranges */
+
+   for (width1 = 0, i = 0; i < count; i++)
+      if (table[i] > width1)
+	 width1 = table[i];
+   width1 = digit_count(width1);
+
+   for (full = false, length = 0, i = 0; i < count; i++)
+   {
+      if (length + width1 > MAXLINE || full)
+      {
+	 fputc('\n', fp);
+	 full   = false;
+	 length = 0;
+      }
+      fprintf(fp, "%*d", width1, table[i]);
+      length += width1;
+      if (i < count - 1 && length + 1 + width1 <= MAXLINE)
+      {
+	 fputc(' ', fp);
+	 length++;
+      }
+      else
+	 full = true;
+   }
+   if (length)
+      fputc('\n', fp);
+
+   free(index);
+   free(table);
+
 /* Determine maximum size of state transition values */
 
    for (width2 = width1 = 0, i = 1; i < DFACOUNT; i++)
@@ -1693,3 +2578,45 @@ void write_scanner
 
    free_automaton(tables);
 }
+
+
+static void write_values
+(
+   int	*values,
+   int	 count,
+   FILE *fp
+)
+{
+/* Write an array of values in lines no longer than MAXLINE */
+
+   bool full;
+   int	length;
+   int	width;
+   int	i;
+
+   for (width = 0, i = 0; i < count; i++)
+      if (values[i] > width)
+	 width = values[i];
+   width = digit_count(width);
+
+   for (full = false, length = 0, i = 0; i < count; i++)
+   {
+      if (length + width > MAXLINE || full)
+      {
+	 fputc('\n', fp);
+	 full   = false;
+	 length = 0;
+      }
+      fprintf(fp, "%*d", width, values[i]);
+      length += width;
+      if (i < count - 1 && length + 1 + width <= MAXLINE)
+      {
+	 fputc(' ', fp);
+	 length++;
+      }
+      else
+	 full = true;
+   }
+   if (length)
+      fputc('\n', fp);
+}
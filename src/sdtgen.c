@@ -25,6 +25,7 @@
 /*									*/
 /*		-g		list the standardized grammar		*/
 /*		-l		list the input file as it is parsed	*/
+/*		-n		write scanner NFA for a lazy DFA	*/
 /*		-q		perform input syntax check only		*/
 /*		-r		list token regular expressions		*/
 /*		-t		list the LR parsing tables		*/
@@ -48,6 +49,8 @@
 /*	  AMBIGUOUS	Use precedence and associtivity to resolve	*/
 /*			shift-reduce conflicts				*/
 /*	  ERRORREPAIR	Generate automatic error repair tables		*/
+/*	  KEYWORDS	Recognize keyword tokens by lookup in a		*/
+/*			perfect hash table instead of scanner states	*/
 /*	  SHIFTREDUCE	Generate shiftreduce parsing actions to		*/
 /*			decrease the size of the parsing tables		*/
 /*	  SPLITSTATES	Attempt to resolve reduce-reduce conflicts by   */
@@ -89,6 +92,7 @@ int main
 )
 {
    bool	 listing;
+   bool	 lazy;
    int	 display;
    int	 debug;
    bool	 process;
@@ -98,11 +102,12 @@ int main
    int	 fd;
 
    listing = false;
+   lazy    = false;
    display = 0;
    debug   = 0;
    process = true;
    output  = "tables.dat";
-   while ((c = getopt(argc, argv, "d:ghlqrtvw:x")) != -1)
+   while ((c = getopt(argc, argv, "d:ghlnqrtvw:x")) != -1)
       switch (c)
       {
 	 case 'd':	/* List debugging output */
@@ -165,6 +170,10 @@ int main
 	    listing = true;
 	    break;
 
+	 case 'n':	/* Write the scanner NFA to be made a DFA lazily */
+	    lazy = true;
+	    break;
+
 	 case 'q':	/* Select syntax check of input only */
 	    process = false;
 	    break;
@@ -212,10 +221,10 @@ int main
          fprintf(stderr, "%s: can't open: %s\n", argv[optind], strerror(errno));
 	 exit(1);
       }
-      init_parser(&sdtgen, fd, &perform_action, &install_token);
+      init_parser(&sdtgen, fd, MAXBUFFER, &perform_action, &install_token);
    }
    else
-      init_parser(&sdtgen, fileno(stdin), &perform_action, &install_token);
+      init_parser(&sdtgen, fileno(stdin), MAXBUFFER, &perform_action, &install_token);
    sdtgen.listing = listing;
 
 /* Perform syntax directed translation of input file */
@@ -224,6 +233,7 @@ int main
    sdtgen.display = display;
    sdtgen.debug   = debug;
    sdtgen.process = process;
+   sdtgen.lazy    = lazy;
 
    init_symbols(&sdtgen);
 
@@ -272,7 +282,7 @@ static void usage
    else
       program++;
 
-   fprintf(stderr, "usage: %s { -[ghlqrtvx] | -d[adefgimnps] | -w tables.dat } [<input file>]\n", program);
+   fprintf(stderr, "usage: %s { -[ghlnqrtvx] | -d[adefgimnps] | -w tables.dat } [<input file>]\n", program);
    exit(1);
 }
 
@@ -295,11 +305,16 @@ static void write_tables
       }
 
 /* Write the header line followed by the scanner and parser tables */
+/* and any keywords found by lookup				   */
 
-   fprintf(fp, "0 %d %d %d %d %d %d %d %d %s\n", tables->termcount, tables->tokenval.token, tables->dfacount,
-      tables->nontermcount, (PRODCOUNT > 1) ? PRODCOUNT - 1 : 0, (COLLCOUNT > 1) ? COLLCOUNT - 1 : 0,
-      tables->repaircontext, tables->repaircost, tables->name);
-   write_scanner(tables, fp);
+   fprintf(fp, "%d %d %d %d %d %d %d %d %d %d %d %s\n", tables->lazy ? 3 : 0, tables->termcount, tables->tokenval.token, tables->dfacount,
+      tables->classcount, tables->nontermcount, (PRODCOUNT > 1) ? PRODCOUNT - 1 : 0, (COLLCOUNT > 1) ? COLLCOUNT - 1 : 0,
+      tables->repaircontext, tables->repaircost, tables->lookaheads > 0, tables->name);
+   if (tables->lazy)
+      write_nfa(tables, fp);
+   else
+      write_scanner(tables, fp);
    write_parser(tables, fp);
+   write_keywords(tables, fp);
    fclose(fp);
 }
@@ -1,356 +1,106 @@
 #include "tables_definitions.h"
 
-static int Tokenindex[147] =
+static int Classmap[257] =
 {
-     0,   0,   0,   1,   2,   3,   4,   5,   6,   7,   8,   9,  10,  11,  12,
-    13,  14,  14,  15,  16,  16,  17,  18,  19,  20,  21,  22,  23,  24,  25,
-    26,  27,  28,  28,  29,  30,  31,  32,  33,  34,  35,  35,  36,  37,  38,
-    39,  40,  41,  42,  43,  44,  45,  46,  47,  48,  49,  50,  51,  52,  53,
-    54,  54,  55,  56,  57,  58,  59,  60,  61,  62,  63,  64,  65,  66,  67,
-    68,  69,  70,  71,  72,  73,  74,  75,  76,  78,  79,  81,  82,  83,  84,
-    85,  86,  87,  88,  90,  92,  93,  94,  95,  96,  97,  98,  99, 100, 101,
-   102, 103, 104, 106, 107, 108, 109, 110, 111, 112, 114, 115, 117, 119, 120,
-   121, 122, 124, 126, 128, 130, 131, 132, 134, 135, 136, 137, 139, 141, 143,
-   145, 146, 148, 149, 150, 151, 152, 153, 155, 156, 157, 159
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  1,  2,  0,  3,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  4,  0,  5,  0,  0,  6,
+    0,  7,  8,  9, 10, 11, 12, 13,  0, 14, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+   15, 16, 17, 18, 19, 20, 21, 22, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23,
+   23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 24, 25, 26,  0,
+   27,  0, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+   28, 28, 28, 28, 28, 28, 28, 28, 28, 29, 30, 31, 32,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0, 33
 };
 
-static int Tokentable[159] =
+static int Tokenindex[38] =
 {
-   45, 23, 44, 23, 37, 38, 33, 34, 41, 29, 27, 25, 35, 42, 40, 32, 21, 21, 21,
-   21, 21, 21, 21, 21, 21, 21, 21, 21, 30, 28, 31, 36, 43, 23, 44, 22, 26, 21,
-   21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 24, 39, 22, 21,
-   21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 24, 21,
-   15, 21, 21, 19, 21, 21, 21, 21, 21, 21, 21, 21,  9, 21, 11, 21, 21, 21, 21,
-   21, 21, 21, 21, 21, 21, 21, 21, 21,  1, 21, 21, 21, 21, 21, 21, 21, 10, 21,
-   21, 18, 21,  2, 21, 21, 21, 21,  4, 21, 14, 21,  6, 21, 13, 21, 21, 21, 16,
-   21, 21, 21, 21, 20, 21, 17, 21, 12, 21,  3, 21, 21,  5, 21, 21, 21, 21, 21,
-   21,  7, 21, 21, 21,  8, 21
+    0,  0,  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 14, 15,
+   16, 16, 17, 17, 18, 19, 20, 21, 22, 23, 24, 24, 25, 26, 27, 27, 28, 29, 30
 };
 
-static int Final[146] =
+static int Tokentable[30] =
+{
+   45, 23, 44, 23, 37, 38, 33, 34, 41, 29, 27, 25, 35, 42, 40, 32, 21, 30, 28,
+   31, 36, 43, 23, 44, 22, 26, 24, 39, 22, 24
+};
+
+static int Final[37] =
 {
     0,  0, 45, 23, 44, 23, 37, 38, 33, 34, 41, 29, 27, 25, 35, 42,  0, 40, 32,
-    0, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21,  0, 30, 28, 31, 36, 43,
-   23, 44,  0, 22, 26, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21,
-   21, 21, 24,  0, 39, 22, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21,
-   21, 21, 21, 21, 21, 24, 21, 15, 21, 19, 21, 21, 21, 21, 21, 21, 21,  9, 11,
-   21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21,  1, 21, 21, 21, 21, 21, 21,
-   10, 21, 18,  2, 21, 21, 21,  4, 14,  6, 13, 21, 21, 16, 21, 21, 21, 20, 17,
-   12,  3, 21,  5, 21, 21, 21, 21, 21,  7, 21, 21,  8
+    0, 21,  0, 30, 28, 31, 36, 43, 23, 44,  0, 22, 26, 24,  0, 39, 22, 24
 };
 
-static char Install[146] =
+static char Install[37] =
 {
-   0, 0, 0, 1, 0, 1, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1,
-   1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 1, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-   1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-   1, 1, 1, 1, 1, 0, 1, 0, 1, 1, 1, 1, 1, 1, 1, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-   1, 1, 1, 0, 1, 1, 1, 1, 1, 1, 0, 1, 0, 0, 1, 1, 1, 0, 0, 0, 0, 1, 1, 0, 1, 1,
-   1, 0, 0, 0, 0, 1, 0, 1, 1, 1, 1, 1, 0, 1, 1, 0
+   0, 0, 0, 1, 0, 1, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0,
+   0, 1, 0, 0, 1, 1, 1, 0, 0, 1, 1
 };
 
-static int Sdefault[146] =
+static int Loopindex[38] =
 {
-    0, 21,  6, 21, 21, 21, 21,  6,  6,  6,  6,  6,  6,  6,  6,  6, 21,  6,  6,
-    6, 21,  0, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21,  6,  6,  6,  6,  6,
-    6,  6,  6, 16, 19, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21,
-   21, 21, 32, 32,  6,  6, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21,
-   21, 21, 21, 21, 21,  6, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21,
-   21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21,
+    0,  0,  0,  6, 12, 18, 24, 24, 24, 24, 24, 24, 24, 24, 26, 26, 26, 26, 26,
+   26, 26, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 40, 42, 48, 48, 48, 48, 48
+};
+
+static int Looptable[48] =
+{
+     9,  10,  12,  12,  32,  32,   0,   9,  11,  33,  35, 255,   0,   9,  11,
+    36,  38, 255,   0,   9,  11,  38,  40, 255,  48,  57,  48,  57,  65,  90,
+    95,  95,  97, 122,   0,   9,  11,  61,  63, 255,  48,  57,   0,   9,  11,
+    91,  94, 255
+};
+
+static uint8_t Sdefault[37] =
+{
+    0,  2,  6,  6,  6,  6,  0,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,
+    6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6, 16, 19, 21, 21,  6,  6,  6
+};
+
+static uint8_t Sbase[37] =
+{
+     0,  47,  38, 147, 180, 213,   0,   0,   0,   0,   0,  23,   0,  19,   0,
+     0, 114,   0,   0,  20,  23,  81,   0,   0,   0,   0,   0,   0,   0,  17,
+    27,   0,  17,  19,   0,   0,   0
+};
+
+static uint8_t Scheck[247] =
+{
+    6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,
+    6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6, 13, 19, 11, 29,
+   20,  2,  2,  2,  2, 32, 33, 33, 20, 30,  1,  1, 20, 20,  1,  1,  1,  1,  1,
+    1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,
+    1,  1,  1,  1,  1, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21,
    21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21,
-   21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21
-};
-
-static int Sbase[146] =
-{
-      0,  564,  468, 1239, 1495, 1751,  440,    0,    0,    0,    0,  357,    0,
-    408,    0,    0,  983,    0,    0,  515,  249,    0,  374,  188,  376,  189,
-    307,  316,  373,  275,  368,  276,  727,    0,    0,    0,    0,    0,    0,
-      0,  341,  345,    0,  250,  251,  326,  338,  190,  210,  252,  324,  243,
-    190,  254,  191,  324,  263,  264,  191,  313,  318,    0,    0,  308,  192,
-    192,  193,  340,  193,  244,  309,  365,  194,  194,  271,  254,  323,  325,
-    245,  256,  274,    0,  324,    0,  195,    0,  313,  246,  195,  196,  257,
-    258,  265,    0,    0,  310,  196,  197,  197,  247,  198,  198,  272,  311,
-    275,  199,  200,    0,  201,  199,  276,  248,  259,  325,    0,  202,    0,
-      0,  266,  200,  201,    0,    0,    0,    0,  309,  259,    0,  203,  261,
-    202,    0,    0,    0,    0,  249,    0,  273,  325,  314,  204,  274,    0,
-    203,  312,    0
-};
-
-static int Scheck[2008] =
-{
-    21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,
-    21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,
-    21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,
-    21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,
-    21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,
-    21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,
-    21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,
-    21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,
-    21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,
-    21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,
-    21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,
-    21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,
-    21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,
-    21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,
-    21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,
-    21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,
-    21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,
-    21,  21,  23,  25,  47,  54,  64,  68,  73,  84,  96,  97, 101, 105, 106,
-   108, 115, 128, 140,  52,  58,  65,  66,  72,  88,  89,  98, 100, 109, 119,
-   120, 130, 143,  48,  23,  25,  47,  54,  64,  68,  73,  84,  96,  97, 101,
-   105, 106, 108, 115, 128, 140,  52,  58,  65,  66,  72,  88,  89,  98, 100,
-   109, 119, 120, 130, 143,  48,  51,  69,  78,  87,  99, 111, 135,  56,  57,
-    92, 118,  20,  43,  44,  49,  53,  75,  79,  90,  91, 112, 126, 129,  74,
-   102, 137, 141,  29,  31,  80, 104, 110,  51,  69,  78,  87,  99, 111, 135,
-    56,  57,  92, 118,  20,  43,  44,  49,  53,  75,  79,  90,  91, 112, 126,
-   129,  74, 102, 137, 141,  29,  31,  80, 104, 110, 125,  26,  63,  70,  95,
-    76,  82, 138, 113,  50,  55,  27,  77,  86, 103, 139, 144,  11,  40,  45,
-    67,  59,  41,  46,  45,  60,  60,  11,  67,  46,  11,  11, 125,  26,  63,
-    70,  95,  76,  82, 138, 113,  50,  55,  27,  77,  86, 103, 139, 144,  71,
-    30,  45,  67,  28,  22,  46,  45,  11,  11,  24,  67,  46,  24,  11,  71,
-    11,  11,  30,  22,  24,  28,  13,  13,  13,  13,  13,  13,  13,  13,  13,
-    13,  71,  30,   2,   2,  28,  22,   2,   2,   2,   2,  24,   2,   2,  24,
-     2,  71,   2,   2,  30,  22,  24,  28,   6,   6,   6,   6,   6,   6,   6,
-     6,   6,   6,   2,   2,   2,   2,   2,   2,   2,   6,   6,   6,   6,   6,
-     6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,
-     6,   6,   6,   6,   6,   6,   2,   2,   2,   2,   6,   2,   6,   6,   6,
-     6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,
-     6,   6,   6,   6,   6,   6,   6,   6,  19,  19,  19,  19,  19,  19,  19,
-    19,  19,  19,   1,   1,   2,   1,   2,   2,   2,   2,   2,   2,   2,   2,
-     2,   2,   2,   2,   2,   2,   2,   2,   2,   2,   2,   1,   2,   1,   2,
-     2,   1,   2,   1,   1,   1,   1,   1,   1,   1,   2,   1,   1,   1,   1,
-     1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   2,   1,   1,   1,
-     2,   1,   1,   2,   2,   2,   2,   1,   2,   2,   1,   2,   1,   1,   1,
-     2,   1,   1,   1,   2,   2,   2,   2,   2,   2,   1,   2,   2,   2,   2,
-     2,   1,   2,   1,   1,   2,   2,   2,   2,   1,   2,   2,   1,   2,   1,
-     1,   1,   2,   1,   1,   1,   2,   2,   2,   2,   2,   2,   1,   1,   1,
-     1,   2,   2,   2,   2,   2,   2,   2,   2,   2,   2,   2,   2,   2,   2,
-     2,   2,   2,   2,   2,   2,   2,   2,   2,   2,   2,   2,   2,   2,   2,
-     2,   2,   2,   2,   2,  19,  19,  32,  32,  32,  32,  32,  32,  32,  32,
-    32,  32,  19,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,
-    32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,
-    32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,
-    32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,
-    32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,
-    32,  32,  32,  32,  32,  32,  32,  32,  32,  32,   1,  32,  32,  32,  32,
-    32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,
-    32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,
-    32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,
-    32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,
-    32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,
-    32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,
-    32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,
-    32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,
-    32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,
-    32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,  32,
-    32,  32,  32,  32,  32,  32,  32,  32,  16,  16,  16,  16,  16,  16,  16,
-    16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,
-    16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,
-    16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,
-    16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,
-    16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,
-    16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,
-    16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,
-    16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,
-    16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,
-    16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,
-    16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,
-    16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,
-    16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,
-    16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,
-    16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,
-    16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,
-    16,  16,  16,  16,  16,  16,  16,  16,  16,   3,   3,   3,   3,   3,   3,
-     3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,
-     3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,
-     3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,
-     3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,
-     3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,
-     3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,
-     3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,
-     3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,
-     3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,
-     3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,
-     3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,
-     3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,
-     3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,
-     3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,
-     3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,
-     3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,
-     3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   4,   4,   4,   4,   4,
-     4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,
-     4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,
-     4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,
-     4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,
-     4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,
-     4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,
-     4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,
-     4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,
-     4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,
-     4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,
-     4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,
-     4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,
-     4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,
-     4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,
-     4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,
-     4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,
-     4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   5,   5,   5,   5,
-     5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
-     5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
-     5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
-     5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
-     5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
-     5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
-     5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
-     5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
-     5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
-     5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
-     5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
-     5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
-     5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
-     5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
-     5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
-     5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
-     5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5
-};
-
-static int Snext[2008] =
-{
-     0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
-     0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
-     0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
-     0,   0,   0,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,   0,   0,
-     0,   0,   0,   0,   0,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,
-    21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,
-    21,   0,   0,   0,   0,  21,   0,  21,  21,  21,  21,  21,  21,  21,  21,
-    21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,  21,
-    21,  21,  21,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
-     0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
-     0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
-     0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
-     0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
-     0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
-     0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
-     0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
-     0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
-     0,   0,  46,  50,  69,  76,  83,  88,  94, 103, 112, 113, 117, 121, 122,
-   123, 129, 135, 142,  74,  80,  84,  85,  93, 106, 107, 114, 116, 124, 131,
-   132, 137, 144,  70,  46,  50,  69,  76,  83,  88,  94, 103, 112, 113, 117,
-   121, 122, 123, 129, 135, 142,  74,  80,  84,  85,  93, 106, 107, 114, 116,
-   124, 131, 132, 137, 144,  70,  73,  89,  99, 105, 115, 126, 138,  78,  79,
-   110, 130,  43,  63,  64,  71,  75,  96, 100, 108, 109, 127, 134, 136,  95,
-   118, 139, 143,  55,  58, 101, 120, 125,  73,  89,  99, 105, 115, 126, 138,
-    78,  79, 110, 130,  43,  63,  64,  71,  75,  96, 100, 108, 109, 127, 134,
-   136,  95, 118, 139, 143,  55,  58, 101, 120, 125, 133,  51,  82,  90, 111,
-    97, 102, 140, 128,  72,  77,  52,  98, 104, 119, 141, 145,  40,  61,  65,
-    86,  81,  62,  67,  66,  59,  59,   0,  87,  68,   0,   0, 133,  51,  82,
-    90, 111,  97, 102, 140, 128,  72,  77,  52,  98, 104, 119, 141, 145,  91,
-    56,  65,  86,  53,  44,  67,  66,   0,   0,  47,  87,  68,  48,   0,  92,
-     0,   0,  57,  45,  49,  54,  13,  13,  13,  13,  13,  13,  13,  13,  13,
-    13,  91,  56,   0,   0,  53,  44,   0,   0,   0,   0,  47,   2,   2,  48,
-     2,  92,   0,   0,  57,  45,  49,  54,   0,   0,   0,   0,   0,   0,   0,
-     0,   0,   0,   0,   0,   2,   0,   0,   0,   0,   0,   0,   0,   0,   0,
-     0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
-     0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
-     0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
-     0,   0,   0,   0,   0,   0,   0,   0,  42,  42,  42,  42,  42,  42,  42,
-    42,  42,  42,   2,   2,   0,   2,   0,   0,   0,   0,   0,   0,   0,   0,
-     0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   2,   0,   3,   0,
-     0,   4,   0,   5,   6,   7,   8,   9,  10,  11,   0,  12,  13,  13,  13,
-    13,  13,  13,  13,  13,  13,  13,  14,  15,  16,  17,   0,  18,  19,  20,
-     0,  22,  23,   0,   0,   0,   0,  24,   0,   0,  25,   0,  26,  27,  28,
-     0,  29,  30,  31,   0,   0,   0,   0,   0,   0,  32,   0,   0,   0,   0,
-     0,  20,   0,  22,  23,   0,   0,   0,   0,  24,   0,   0,  25,   0,  26,
-    27,  28,   0,  29,  30,  31,   0,   0,   0,   0,   0,   0,  33,  34,  35,
-    36,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
-     0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
-     0,   0,   0,   0,   0,   0,   0,  59,  59,  59,  59,  59,  59,  59,  59,
-    59,  59,   0,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,
-    59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,
-    59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,
-    59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,
-    59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,
-    59,  59,  59,  59,  59,  59,  59,  59,  59,  60,  37,  59,  59,  59,  59,
-    59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,
-    59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,
-    59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,
-    59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,
-    59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,
-    59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,
-    59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,
-    59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,
-    59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,
-    59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,  59,
-    59,  59,  59,  59,  59,  59,  59,  59,  41,  41,  41,  41,  41,  41,  41,
-    41,  41,  41,   0,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,
-    41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,
-    41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,
-    41,  41,  41,  41,  41,  41,  41,  41,  41,  41,   0,  41,  41,  41,  41,
-    41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,
-    41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,
-    41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,
-    41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,
-    41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,
-    41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,
-    41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,
-    41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,
-    41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,
-    41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,
-    41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,
-    41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,
-    41,  41,  41,  41,  41,  41,  41,  41,  41,   3,   3,   3,   3,   3,   3,
-     3,   3,   3,   3,   0,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,
-     3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,  38,   3,
-     3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,
-     3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,
-     3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,
-     3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,
-     3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,
-     3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,
-     3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,
-     3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,
-     3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,
-     3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,
-     3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,
-     3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,
-     3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,
-     3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,
-     3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   4,   4,   4,   4,   4,
-     4,   4,   4,   4,   4,   0,   4,   4,   4,   4,   4,   4,   4,   4,   4,
-     4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,
-     4,   4,  39,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,
-     4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,
-     4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,
-     4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,
-     4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,
-     4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,
-     4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,
-     4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,
-     4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,
-     4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,
-     4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,
-     4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,
-     4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,
-     4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,
-     4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   5,   5,   5,   5,
-     5,   5,   5,   5,   5,   5,   0,   5,   5,   5,   5,   5,   5,   5,   5,
-     5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
-     5,   5,   5,   5,   5,  38,   5,   5,   5,   5,   5,   5,   5,   5,   5,
-     5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
-     5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
-     5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
-     5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
-     5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
-     5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
-     5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
-     5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
-     5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
-     5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
-     5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
-     5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
-     5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
-     5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   0
+   16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16,
+   16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16,  3,  3,  3,  3,  3,
+    3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,
+    3,  3,  3,  3,  3,  3,  3,  3,  3,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,
+    4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,
+    4,  4,  4,  4,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,
+    5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5
+};
+
+static uint8_t Snext[247] =
+{
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 13, 31, 29, 34,
+   20,  2,  2,  2,  2, 36, 32, 32, 20, 35,  2,  2, 20, 20,  3,  4,  5,  6,  7,
+    8,  9, 10, 11, 12, 13, 14, 15, 16, 17,  0, 18, 19, 20, 21,  0,  0, 20, 20,
+   22, 23, 24, 25, 26, 32, 32,  0, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32,
+   32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 33,  0, 32, 32, 32, 32, 32, 32,
+   30, 30,  0, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30,
+   30,  0, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30,  3,  3,  0,  3,  3,
+   27,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,
+    3,  3,  3,  3,  3,  3,  3,  3,  3,  4,  4,  0,  4,  4,  4, 28,  4,  4,  4,
+    4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,
+    4,  4,  4,  4,  5,  5,  0,  5,  5,  5,  5, 27,  5,  5,  5,  5,  5,  5,  5,
+    5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  0
 };
 
 static int Inscost[44] =
@@ -425,97 +175,161 @@ static char Stringtable[507] =
    "bute ListAttributeAlternate ListAlternateSymbol ListSymbol"
 };
 
-static int Pbase[81] =
-{
-     0,   9,   1,   3,   0,   6,  12,  15,  28, 144,   7,  54,  78, 191,  19,
-    82, 230, 312,   9, 208, 140,  17,  86,  99,  71, 216, 322, 226, 206,   0,
-   118,  48, 227, 102, 150, 146, 158,   1, 136, 158, 159, 196, 109, 140, 202,
-     1, 318, 285, 326, 125, 148, 216,   1, 202, 203, 219, 220,  63, 239, 239,
-   240, 227, 150, 274,  70, 225, 235, 271,  23, 278, 282,  37, 271, 272, 283,
-    39, 296, 258,  98, 303, 108
-};
-
-static int Pcheck[404] =
-{
-    0,  0,  4,  4,  4,  4,  0, 37, 37, 37,  1, 10, 10, 37, 37, 37, 52,  0,  7,
-    7,  7, 29,  2, 29, 29, 18, 18, 29, 29, 45, 29, 29, 68, 68, 68,  6, 29, 29,
-   29, 45, 14, 29, 29, 71, 71, 71,  3,  4,  5, 71, 71, 71, 21,  1,  1,  1, 10,
-   21, 21, 21, 18, 75, 75,  7, 29, 29, 29, 29, 29, 31,  8, 31, 31, 37, 37, 31,
-   31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 24, 21, 31, 31, 64, 22, 64, 64,
-   11, 11, 64, 64, 12, 64, 64, 22, 22, 57, 57, 64, 64, 64, 22, 71, 64, 64, 75,
-   75, 75, 75, 23, 23, 23, 78, 78, 15, 24, 78, 42, 78, 42, 42, 42, 80, 80, 12,
-   12, 64, 64, 64, 64, 64, 30, 78, 30, 30, 22, 33, 30, 30, 30, 30, 30, 30, 30,
-   30, 49, 30, 30, 30, 23, 23, 30, 30, 20, 43, 20, 20,  9, 49, 49, 42, 35, 20,
-   34, 62, 34, 34, 78, 20, 20, 38, 36, 34, 36, 36, 80, 80, 80, 34, 34, 36, 50,
-   50, 34, 34, 62, 36, 36, 13,  9, 39, 40, 43, 43, 20, 20, 20, 20, 20, 20, 20,
-   20, 20, 62, 34, 34, 34, 34, 34, 34, 34, 50, 36, 36, 36, 36, 36, 36, 36, 36,
-   36, 19, 44, 19, 19, 44, 28, 16, 41, 25, 19, 25, 25, 13, 53, 54, 19, 19, 25,
-   27, 28, 27, 27, 16, 25, 25, 32, 32, 27, 51, 51, 55, 56, 58, 27, 27, 59, 60,
-   61, 65, 32, 32, 19, 19, 19, 19, 19, 19, 19, 66, 25, 25, 25, 25, 25, 25, 25,
-   16, 77, 51, 27, 27, 27, 27, 27, 27, 27, 63, 67, 63, 63, 63, 77, 63, 63, 69,
-   63, 63, 47, 70, 47, 47, 63, 63, 63, 72, 73, 63, 63, 76, 17, 76, 76, 47, 47,
-   76, 76, 74, 76, 76, 79,  0,  0, 76, 76, 76, 76, 17,  0, 76, 76, 46,  0, 46,
-   46, 26,  0, 26, 26, 48, 46, 48, 48, 47, 47, 47, 46, 46,  0,  0,  0, 26,  0,
-    0,  0, 48,  0,  0,  0,  0, 17, 17,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-    0, 46, 46, 46, 46, 46, 46,  0,  0, 26, 26,  0,  0,  0, 48,  0,  0,  0,  0,
-    0,  0,  0,  0,  0
-};
-
-static int Pnext[404] =
-{
-        0,      0,  10006,     -4,     -4,     -4,      0,  10052,  10053,
-    10054,  10002,  10012,     -8,     62,  10055,  10056,     63,      0,
-    10009,     -6,     -6,     51,  10005,     50,     52,    -11,  10023,
-      -33,    -33,  10046,  10025,    -33,     69,     68,     67,  10008,
-    10026,  10027,    -33,     53,     15,    -33,    -33,  10052,  10053,
-    10054,      1,  10007,      3,     62,  10055,  10056,  10035, -10000,
-    10003,  10004,  10013,  10036,  10037,    -58,  10024,     77,     76,
-    10010,     36,  10030,     44,     46,  10031,    -48,      5,    -48,
-      -48,  10057,     60,    -48,    -48,    -48,    -48,    -48,    -48,
-      -48,    -48,  10048,    -48,    -48,    -48,  10043,  10038,    -48,
-      -48,     51,  10020,     50,     52,  10014,      7,    -34,    -34,
-    10015,  10025,    -34,    -10,    -10,  10071,    -59,  10026,  10027,
-      -34,  10021,     61,    -34,    -34,  10077,     70,  10078,     74,
-    10039,  10040,  10041,     77,     76,  10019,      2,     73,    -12,
-      -72,  10039,  10040,  10041,     77,     76,  10016,     16,     36,
-    10030,     44,     46,  10031,    -37,    -72,    -37,    -37,     20,
-       23,    -37,    -37,  10047,    -37,    -37,     40,     38,     39,
-    10046,    -37,    -37,    -37,  10042,     25,    -37,    -37,     51,
-    10061,     50,     52,     14,    -56,    -56,     26,  10050,  10025,
-       51,  10061,     50,     52,     75,  10026,  10027,     21,     51,
-    10025,     50,     52,     71,  10078,     74,  10026,  10027,  10025,
-    10037,    -58,    -55,    -55,    -13,  10026,  10027,  10017,  10011,
-    10058,  10059,  10062,     30,  10032,  10029,     35,  10030,     44,
-       46,  10031,  10033,  10034,     31,  10049,  10029,     35,  10030,
-       44,     46,  10031,  10065,  10032,  10029,     35,  10030,     44,
-       46,  10031,  10051,  10034,     51,  10046,     50,     52,  10063,
-    10046,     -9,  10060,     51,  10025,     50,     52,  10018,  10067,
-    10068,  10026,  10027,  10025,     51,     18,     50,     52,  10015,
-    10026,  10027,     57,  10046,  10025,  10037,    -58,  10069,  10070,
-    10072,  10026,  10027,  10073,  10074,  10075,     22,    -54,    -54,
-    10028,  10029,     35,  10030,     44,     46,  10031,     24,  10044,
-    10029,     35,  10030,     44,     46,  10031,     17,  10080,  10066,
-    10045,  10029,     35,  10030,     44,     46,  10031,    -41,     66,
-      -41,    -41,  10076,     32,    -41,    -41,     64,    -41,    -41,
-       51,     65,     50,     52,    -41,    -41,    -41,     29,     27,
-      -41,    -41,    -42,  10020,    -42,    -42,  10026,  10027,    -42,
-      -42,     28,    -42,    -42,     43,      0,      0,  10079,    -42,
-      -42,    -42,  10021,      0,    -42,    -42,     51,      0,     50,
-       52,     51,      0,     50,     52,     51,  10025,     50,     52,
-       45,     46,  10031,  10026,  10027,      0,      0,      0,  10027,
-        0,      0,      0,  10027,      0,      0,      0,      0,  10022,
-       19,      0,      0,      0,      0,      0,      0,      0,      0,
-        0,      0,      0,  10064,     35,  10030,     44,     46,  10031,
-        0,      0,     47,  10031,      0,      0,      0,     49,      0,
-        0,      0,      0,      0,      0,      0,      0,      0
+static uint8_t Pbase[81] =
+{
+     0,   0,  52,  45,   0,  68, 100, 127,  94,  12, 101, 173,   1,  57, 126,
+   109,  96,  38, 110, 118,  88,  79, 181,   0,  50, 122,  55, 139,  49,   0,
+    66,  22,  42, 111,  92, 142, 114,   0, 130, 138, 154, 165, 209,   7, 202,
+   171, 187,  11, 198, 149, 115, 141, 211, 191, 201, 202, 203, 198, 222, 220,
+   221, 208, 118, 143,  44, 206, 207, 225, 227, 226, 227,   3, 211, 212, 213,
+     3, 165, 192, 190, 231,  17
+};
+
+static uint8_t Pcheck[275] =
+{
+    0,  1,  4,  4,  4,  4, 37, 37, 37, 71, 71, 71, 37, 37, 37, 71, 71, 71, 23,
+   23, 23, 29, 12, 29, 29, 75, 75, 29, 29, 43, 29, 29, 47,  9, 47, 47, 29, 29,
+   29, 80, 80, 29, 29, 31, 17, 31, 31, 47, 47, 31, 31, 31, 31, 31, 31, 31, 31,
+   31, 31, 31, 31, 17, 13, 31, 31, 64, 24, 64, 64, 32, 32, 64, 64,  2, 64, 64,
+   26, 28, 26, 26, 64, 64, 64, 32, 32, 64, 64, 30,  3, 30, 30, 28, 26, 30, 30,
+   30, 30, 30, 30, 30, 30, 16, 30, 30, 30, 10, 10, 30, 30, 20,  5, 20, 20, 34,
+   21, 34, 34, 16, 20, 21, 21, 21, 34,  6, 20, 20, 18, 18, 34, 34,  7,  7,  7,
+   34, 34, 36,  8, 36, 36, 19, 62, 19, 19, 25, 36, 25, 25, 14, 19, 15, 36, 36,
+   25, 33, 19, 19, 50, 50, 25, 25, 27, 62, 27, 27, 63, 35, 63, 63, 63, 27, 63,
+   63, 38, 63, 63, 27, 27, 49, 39, 63, 63, 63, 51, 51, 63, 63, 76, 22, 76, 76,
+   49, 49, 76, 76, 40, 76, 76, 22, 22, 45, 76, 76, 76, 76, 22, 41, 76, 76, 46,
+   45, 46, 46, 78, 78, 11, 11, 78, 46, 78, 48, 77, 48, 48, 46, 46, 42, 52, 42,
+   42, 42, 44, 53, 78, 44, 77, 48, 68, 68, 68, 57, 57, 54, 55, 56, 58, 59, 60,
+   61, 65, 66, 67, 69, 70, 72, 73, 74, 79,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0
+};
+
+static int16_t Pnext[275] =
+{
+       0, 10002, 10006,    -4,    -4,    -4, 10052, 10053, 10054, 10052, 10053,
+   10054,    62, 10055, 10056,    62, 10055, 10056, 10039, 10040, 10041,    51,
+   10015,    50,    52,    77,    76,   -33,   -33, 10061, 10025,   -33,    51,
+      14,    50,    52, 10026, 10027,   -33,    77,    76,   -33,   -33,   -48,
+   10020,   -48,   -48, 10026, 10027,   -48,   -48,   -48,   -48,   -48,   -48,
+     -48,   -48, 10048,   -48,   -48,   -48, 10021, 10017,   -48,   -48,    51,
+   10043,    50,    52,    57, 10046,   -34,   -34, 10005, 10025,   -34,    51,
+   10046,    50,    52, 10026, 10027,   -34,   -54,   -54,   -34,   -34,   -37,
+       1,   -37,   -37,    18, 10027,   -37,   -37, 10047,   -37,   -37,    40,
+      38,    39,    -9,   -37,   -37,   -37, 10012,    -8,   -37,   -37,    51,
+       3,    50,    52,    51, 10035,    50,    52, 10015, 10025, 10036, 10037,
+     -58, 10025, 10008, 10026, 10027,   -11, 10023, 10026, 10027, 10009,    -6,
+      -6,   -55,   -55,    51,     5,    50,    52,    51, 10061,    50,    52,
+      51, 10025,    50,    52,    15, 10025, 10019, 10026, 10027, 10025,    23,
+   10026, 10027, 10037,   -58, 10026, 10027,    51,   -13,    50,    52,   -41,
+   10050,   -41,   -41, 10076, 10025,   -41,   -41,    21,   -41,   -41, 10026,
+   10027, 10046, 10058,   -41,   -41,   -41, 10037,   -58,   -41,   -41,   -42,
+   10020,   -42,   -42,   -56,   -56,   -42,   -42, 10059,   -42,   -42,   -10,
+     -10, 10046, 10079,   -42,   -42,   -42, 10021, 10060,   -42,   -42,    51,
+      53,    50,    52,    77,    76, 10014,     7,    73, 10025,   -72,    51,
+   10080,    50,    52, 10026, 10027,   -12,    63, 10039, 10040, 10041, 10046,
+   10067,   -72, 10063,    32, 10027,    69,    68,    67, 10071,   -59, 10068,
+   10069, 10070, 10072, 10073, 10074, 10075,    22,    24,    66,    64,    65,
+      29,    27,    28,    43,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,     0
+};
+
+static int16_t Gdefault[35] =
+{
+        0, -10000,  10003,  10004,  10007,  10010,  10013,  10018,  10024,
+        2,  10011,  10016,     16,  10022,     19,  10042,     25,  10062,
+       30,  10032,  10029,     35,  10030,     44,     46,  10031,  10033,
+    10034,  10038,  10057,     60,  10077,     70,  10078,     74
+};
+
+static uint8_t Gbase[35] =
+{
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+static uint8_t Gcheck[81] =
+{
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 12,  0,  0,
+   19,  0,  0, 14,  0,  0, 19, 24, 19,  0, 21,  0,  0,  0,  0, 19,  0, 26,  0,
+    0,  0,  0,  0, 16,  0,  0,  0, 20, 23, 25,  0, 28, 28,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0, 18,  0, 21,  0,  0,  0,  0,  0,  0, 30,  0,  0,  0,  0,
+    0,  0, 34,  0, 32
+};
+
+static uint16_t Gnext[81] =
+{
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,    17,     0,     0, 10028,     0,     0,
+      20,     0,     0, 10044,    47, 10045,     0,    36,     0,     0,     0,
+       0, 10049,     0, 10051,     0,     0,     0,     0,     0,    26,     0,
+       0,     0, 10064,    45,    49,     0, 10065, 10066,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,    31,     0,    36,     0,
+       0,     0,     0,     0,     0,    61,     0,     0,     0,     0,     0,
+       0,    75,     0,    71
+};
+
+static int Kwseed[10] =
+{
+   28,  0, 14,  0,  0, 14,  0, 25, 25,  4
+};
+
+static int Kwtoken[20] =
+{
+    7,  9, 19, 18,  3, 20, 17,  4, 16, 13,  6,  8, 14, 10, 15, 11,  1, 12,  2,
+    5
+};
+
+static int Kwbase[20] =
+{
+   21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21,
+   21
+};
+
+static char Kwinstall[20] =
+{
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+static char Kwfold[20] =
+{
+   1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1
+};
+
+static int Kwnameindex[21] =
+{
+     0,  10,  14,  18,  23,  30,  37,  44,  50,  56,  62,  68,  81,  87,  92,
+    96, 100, 105, 112, 117, 124
+};
+
+static char Kwnametable[125] =
+{
+   "PRECEDENCELEFTCOSTSTARTOPTIONSCONTEXTDEFAULTDEFINEPARSERINSERTIGNOREASSOCIA"
+   "TIVITYDELETERIGHTCASENONEIDENTINSTALLTITLESCANNER"
+};
+
+static char Kwcheck[46] =
+{
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+static keywordentry Keywords =
+{
+   20, 10, 13, Kwseed, Kwtoken, Kwbase, Kwinstall, Kwfold,
+   Kwnameindex, Kwnametable, Kwcheck
 };
 
 sdt_tables sdtgen =
 {
-   45, 43, 34, 5, 20,
+   45, 43, 34, 5, 20, false,
    Tokenindex, Tokentable, Final, Install,
-   Sdefault, Sbase, Scheck, Snext,
+   Classmap, {UINT8_TABLE, Sdefault}, {UINT8_TABLE, Sbase},
+   {UINT8_TABLE, Scheck}, {UINT8_TABLE, Snext},
+   Loopindex, Looptable,
    Inscost, Delcost, Lhstoken, Rhslength, Semantics,
    Repair, Stringindex, Stringtable,
-   Pbase, Pcheck, Pnext
+   {UINT8_TABLE, Pbase}, {UINT8_TABLE, Pcheck}, {INT16_TABLE, Pnext},
+   {INT16_TABLE, Gdefault}, {UINT8_TABLE, Gbase},
+   {UINT8_TABLE, Gcheck}, {UINT16_TABLE, Gnext},
+   NULL, NULL, NULL, &Keywords
 };
@@ -21,6 +21,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
 #include "dynarray_definitions.h"
 #include "scangen_definitions.h"
@@ -34,20 +35,24 @@
 #define INITIAL_NAME_SIZE	8
 
 
-static void compare_scanner(int **, int, int ***);
-static void complete_scanner(int **, int, int *, int *, dynarray *, dynarray *, int *);
+static void compare_scanner(int **, int, int, int ***);
+static void complete_scanner(int **, int, int, int *, int *, dynarray *, dynarray *, int *);
 static void compress_parser(int **, int, int, int *, dynarray *, dynarray *);
-static void compress_scanner(int **, int *, int, int **, int *, int *, dynarray *, dynarray *, int *);
+static void compress_scanner(int **, int, int *, int, int **, int *, int *, dynarray *, dynarray *, int *);
 static void compute_average(int **, int, double **);
+static void copy_keywords(int, int, FILE *, FILE *);
+static void copy_nfa(int, FILE *, FILE *);
 static void copy_string(int, FILE *, FILE *);
-static void insert_scanner(int **, int, int, int *, int *, dynarray *, dynarray *, int **);
+static void insert_scanner(int **, int, int, int, int *, int *, dynarray *, dynarray *, int **);
 static void load_actions(FILE *, int, int, int **, int ***);
-static void load_transitions(FILE *, int, int ***);
+static void load_transitions(FILE *, int, int, int ***);
 static void read_name(dynarray *, FILE *);
 static int  read_table(int **, int, FILE *);
 static void sort_parser(int *, int, int **);
 static void sort_scanner(double *, int, int **);
-static int  state_mismatch(int **, int, int);
+static void split_gotos(int **, int, int, int, int *, int **, int ***);
+static int  state_mismatch(int **, int, int, int);
+static void usage(char *);
 static void write_table(int *, int, FILE *);
 
 
@@ -55,6 +60,7 @@ static void compare_scanner
 (
    int	**actions,
    int	  states,
+   int	  classes,
    int ***compare
 )
 {
@@ -79,7 +85,7 @@ static void compare_scanner
 
    for (i = 0; i < states; i++)
       for (j = i; j < states; j++)
-	 (*compare)[i][j] = (*compare)[j][i] = state_mismatch(actions, i, j);
+	 (*compare)[i][j] = (*compare)[j][i] = state_mismatch(actions, classes, i, j);
 }
 
 
@@ -87,6 +93,7 @@ static void complete_scanner
 (
    int	   **actions,
    int	     states,
+   int	     classes,
    int	    *tdefault,
    int	    *tbase,
    dynarray *tcheck,
@@ -116,7 +123,7 @@ static void complete_scanner
 /* Examine states from longest to shortest chain filling in unused table entries */
 
    for (i = 0; i < states; i++)
-      for (j = 0; j < MAPCOUNT; j++)
+      for (j = 0; j < classes; j++)
 	 if (DYNARRAY(int, *tcheck, tbase[index[i]] + j) == 0)
 	 {
 	    DYNARRAY(int, *tcheck, tbase[index[i]] + j) = index[i] + 1;
@@ -180,6 +187,7 @@ static void compress_parser
 static void compress_scanner
 (
    int	   **actions,
+   int	     classes,
    int	    *index,
    int	     entry,
    int	   **compare,
@@ -198,7 +206,7 @@ static void compress_scanner
 
 /* Find the first previously inserted state which is most similar to this one */
 
-   for (value = MAPCOUNT + 1, min = i = 0; i < entry; i++)
+   for (value = classes + 1, min = i = 0; i < entry; i++)
       if (compare[index[entry]][index[i]] < value)
       {
 	 value = compare[index[entry]][index[i]];
@@ -209,12 +217,12 @@ static void compress_scanner
 
 /* Find the transitions which differ between this state and its default */
 
-   for (i = 0; i < MAPCOUNT; i++)
+   for (i = 0; i < classes; i++)
       diff[i] = (actions[index[entry]][i] != actions[index[min]][i]);
 
-/* Make sure there are at least MAPCOUNT entries free after the end of the tables */
+/* Make sure there are at least classes entries free after the end of the tables */
 
-   while (DYNCOUNT(*tcheck) + MAPCOUNT > DYNSIZE(*tcheck))
+   while (DYNCOUNT(*tcheck) + classes > DYNSIZE(*tcheck))
    {
       size = DYNSIZE(*tcheck);
       dynresize(tcheck, size * 2);
@@ -227,25 +235,25 @@ static void compress_scanner
 
    for (i = 0; i < DYNCOUNT(*tcheck); i++)
    {
-      for (j = 0; j < MAPCOUNT && (!diff[j] || DYNARRAY(int, *tcheck, i + j) == 0); j++)
+      for (j = 0; j < classes && (!diff[j] || DYNARRAY(int, *tcheck, i + j) == 0); j++)
 	 ;
-      if (j >= MAPCOUNT)
+      if (j >= classes)
 	 break;
    }
    tbase[index[entry]] = i;
 
 /* Insert the needed entries into the compressed tables */
 
-   for (j = 0; j < MAPCOUNT; j++)
+   for (j = 0; j < classes; j++)
       if (diff[j])
       {
 	 DYNARRAY(int, *tcheck, i + j) = index[entry] + 1;
 	 DYNARRAY(int, *tnext, i + j)  = actions[index[entry]][j];
       }
-   if (DYNCOUNT(*tcheck) < i + MAPCOUNT)
+   if (DYNCOUNT(*tcheck) < i + classes)
    {
-      DYNCOUNT(*tcheck) = i + MAPCOUNT;
-      DYNCOUNT(*tnext)  = i + MAPCOUNT;
+      DYNCOUNT(*tcheck) = i + classes;
+      DYNCOUNT(*tnext)  = i + classes;
    }
 }
 
@@ -285,6 +293,104 @@ static void compute_average
 }
 
 
+static void copy_keywords
+(
+   int	 count,
+   int	 buckets,
+   FILE *input,
+   FILE *output
+)
+{
+/* Copy the perfect hash table of keywords found by lookup, which is */
+/* already as small as it can be				     */
+
+   int *table;
+   int	length;
+   int	i;
+
+/* Copy the bucket seeds and the token, base token, install, and case */
+/* insignificance values of each slot				      */
+
+   read_table(&table, buckets, input);
+   write_table(table, buckets, output);
+   free(table);
+
+   for (i = 0; i < 4; i++)
+   {
+      read_table(&table, count, input);
+      write_table(table, count, output);
+      free(table);
+   }
+
+/* Copy the keyword name index values and the concatenated names */
+
+   length = read_table(&table, count + 1, input);
+   write_table(table, count + 1, output);
+   free(table);
+
+   copy_string(length, input, output);
+
+   fprintf(stderr, "The keyword table has %d keywords in %d hash buckets\n", count, buckets);
+}
+
+
+static void copy_nfa
+(
+   int	 snumber,
+   FILE *input,
+   FILE *output
+)
+{
+/* Copy the scanner NFA from which the parser builds its DFA lazily. */
+/* Nothing is packed since the NFA has no state by class table	     */
+
+   int *table;
+   int	length;
+   int	classes;
+   int	i;
+
+/* Copy the first positions preceded by their count */
+
+   fscanf(input, "%d", &length);
+   fprintf(output, "%d\n", length);
+   read_table(&table, length, input);
+   write_table(table, length, output);
+   free(table);
+
+/* Copy the end of token, final, and install values of each position */
+
+   for (i = 0; i < 3; i++)
+   {
+      read_table(&table, snumber, input);
+      write_table(table, snumber, output);
+      free(table);
+   }
+
+/* Copy the transition class index values and the concatenated classes */
+
+   classes = read_table(&table, snumber + 1, input);
+   write_table(table, snumber + 1, output);
+   free(table);
+
+   read_table(&table, classes, input);
+   write_table(table, classes, output);
+   free(table);
+
+/* Copy the follow set index values and the concatenated follow sets */
+
+   length = read_table(&table, snumber + 1, input);
+   write_table(table, snumber + 1, output);
+   free(table);
+
+   read_table(&table, length, input);
+   write_table(table, length, output);
+   free(table);
+
+   fprintf(stderr, "The scanner NFA has %d positions with %d transition classes and %d follow positions\n",
+      snumber, classes, length);
+}
+
+
 static void copy_string
 (
    int	 count,
@@ -343,6 +449,7 @@ static void insert_scanner
 (
    int	   **actions,
    int	     states,
+   int	     classes,
    int	     index,
    int	    *tdefault,
    int	    *tbase,
@@ -364,7 +471,7 @@ static void insert_scanner
    tdefault[index] = 0;
    (*chain)[index] = 1;
    tbase[index]    = DYNCOUNT(*tcheck);
-   if (DYNCOUNT(*tcheck) + MAPCOUNT > DYNSIZE(*tcheck))
+   if (DYNCOUNT(*tcheck) + classes > DYNSIZE(*tcheck))
    {
       size = DYNSIZE(*tcheck);
       dynresize(tcheck, size * 2);
@@ -372,13 +479,13 @@ static void insert_scanner
       dynresize(tnext, size * 2);
       memset(&DYNARRAY(int, *tnext, size), 0, size * DYNELEMENT(*tnext));
    }
-   for (i = 0; i < MAPCOUNT; i++)
+   for (i = 0; i < classes; i++)
    {
       DYNARRAY(int, *tcheck, tbase[index] + i) = index + 1;
       DYNARRAY(int, *tnext, tbase[index] + i)  = actions[index][i];
    }
-   DYNCOUNT(*tcheck) += MAPCOUNT;
-   DYNCOUNT(*tnext)  += MAPCOUNT;
+   DYNCOUNT(*tcheck) += classes;
+   DYNCOUNT(*tnext)  += classes;
 }
 
 
@@ -432,24 +539,25 @@ static void load_transitions
 (
    FILE	 *input,
    int	  states,
+   int	  classes,
    int ***actions
 )
 {
    int *index;
    int	count;
-   int	ch;
+   int	cls;
    int	next;
    int	i, j;
 
 /* Allocate and initialize a two dimensional transition table */
 
-   if (*actions = (int **) malloc(states * (sizeof(**actions) + MAPCOUNT * sizeof(***actions))))
+   if (*actions = (int **) malloc(states * (sizeof(**actions) + classes * sizeof(***actions))))
    {
-      memset(*actions, 0, states * (sizeof(**actions) + MAPCOUNT * sizeof(***actions)));
+      memset(*actions, 0, states * (sizeof(**actions) + classes * sizeof(***actions)));
       for (index = (int *) &(*actions)[states], i = 0; i < states; i++)
       {
 	 (*actions)[i] = index;
-	 index        += MAPCOUNT;
+	 index        += classes;
       }
    }
    else
@@ -462,8 +570,8 @@ static void load_transitions
       fscanf(input, "%d", &count);
       for (j = 0; j < count; j++)
       {
-	 fscanf(input, "%d %d", &ch, &next);
-	 (*actions)[i][ch] = next;
+	 fscanf(input, "%d %d", &cls, &next);
+	 (*actions)[i][cls] = next;
       }
    }
 }
@@ -512,7 +620,7 @@ static int read_table
       out_of_memory();
    for (i = 0; i < size; i++)
       fscanf(fp, "%d", &(*table)[i]);
-   return((*table)[size - 1]);
+   return(size ? (*table)[size - 1] : 0);
 }
 
 
@@ -576,9 +684,90 @@ static void sort_scanner
 }
 
 
+static void split_gotos
+(
+   int	 **actions,
+   int	   states,
+   int	   tnumber,
+   int	   ntnumber,
+   int	  *gdefault,
+   int	 **count,
+   int	***gotos
+)
+{
+/* Move the entries of the nonterminal columns into a goto table with a	  */
+/* row for each nonterminal.  The most common entry in each column becomes*/
+/* its default, and only the entries which differ from it are kept	  */
+
+   int *index;
+   int *column;				/* Sorted entries of one nonterminal column */
+   int	length;				/* Number of entries in the column */
+   int	run;				/* Number of equal entries in a run */
+   int	longest;			/* Number of entries in the longest run */
+   int	save;
+   int	i, j, k;
+
+/* Allocate and initialize a two dimensional nonterminal by state table */
+
+   if ((*count = (int *) malloc(ntnumber * sizeof(**count))) && (column = (int *) malloc(states * sizeof(*column))))
+      memset(*count, 0, ntnumber * sizeof(**count));
+   else
+      out_of_memory();
+   if (*gotos = (int **) malloc(ntnumber * (sizeof(**gotos) + states * sizeof(***gotos))))
+   {
+      memset(*gotos, 0, ntnumber * (sizeof(**gotos) + states * sizeof(***gotos)));
+      for (index = (int *) &(*gotos)[ntnumber], i = 0; i < ntnumber; i++)
+      {
+	 (*gotos)[i] = index;
+	 index      += states;
+      }
+   }
+   else
+      out_of_memory();
+
+   for (i = 0; i < ntnumber; i++)
+   {
+/*    Sort the entries in this nonterminal's column */
+
+      for (length = j = 0; j < states; j++)
+	 if (save = actions[j][tnumber + i])
+	 {
+	    for (k = length++ - 1; k >= 0 && column[k] > save; k--)
+	       column[k + 1] = column[k];
+	    column[k + 1] = save;
+	 }
+
+/*    The value of the longest run of equal entries is the default */
+
+      gdefault[i] = 0;
+      for (longest = j = 0; j < length; j += run)
+      {
+	 for (run = 1; j + run < length && column[j + run] == column[j]; run++)
+	    ;
+	 if (run > longest)
+	 {
+	    longest     = run;
+	    gdefault[i] = column[j];
+	 }
+      }
+
+/*    Keep the entries that the default does not supply */
+
+      for (j = 0; j < states; j++)
+	 if (actions[j][tnumber + i] && actions[j][tnumber + i] != gdefault[i])
+	 {
+	    (*gotos)[i][j] = actions[j][tnumber + i];
+	    (*count)[i]++;
+	 }
+   }
+   free(column);
+}
+
+
 static int state_mismatch
 (
    int **actions,
+   int	 classes,
    int	 state1,
    int	 state2
 )
@@ -589,13 +778,23 @@ static int state_mismatch
    if (state1 == state2)
       fail = 0;
    else
-      for (fail = i = 0; i < MAPCOUNT; i++)
+      for (fail = i = 0; i < classes; i++)
 	 if (actions[state1][i] != actions[state2][i])
 	    fail++;
    return(fail);
 }
 
 
+static void usage
+(
+   char *argv0
+)
+{
+   fprintf(stderr, "usage: %s [-d] [ input [ output ] ]\n", argv0);
+   exit(1);
+}
+
+
 static void write_table
 (
    int	*table,
@@ -656,15 +855,18 @@ int main
    int	    tnumber;		/* Number of terminals in the language */
    int	    ntokens;		/* Number of tokens including ignored */
    int	    snumber;		/* Number of states in the scanner */
+   int	    cnumber;		/* Number of input character classes */
    int	    ntnumber;		/* Number of nonterminals in the language */
    int	    gnumber;		/* Number of productions in the grammar */
    int	    pnumber;		/* Number of states in the parser */
    int	    context;		/* Number of error repair context tokens */
    int	    defcost;		/* Assumed cost to repair a single error */
+   int	    lookahead;		/* Nonzero if any token has a lookahead */
    dynarray name;		/* Identifying name for tables */
    int	   *table;		/* Generic table of integer values */
    int	    length;		/* Table length returned by index table */
    int	  **actions;		/* Two dimensional state action array */
+   int	  **gotos;		/* Two dimensional nonterminal goto array */
    int	  **compare;		/* Two dimensional comparison of actions */
    double  *average;		/* Distance-weighted mean of compare */
    int	   *index;		/* Index of sorted actions array */
@@ -678,145 +880,200 @@ int main
    double   total;		/* Total of all scanner table chain lengths */
    int	    max;		/* Maximum scanner table chain length */
    int	   *count;		/* Number of actions per parser state */
+   bool	    dense;		/* True for direct indexed scanner tables */
+   int	    keywords;		/* Number of keywords found by lookup */
+   int	    buckets;		/* Number of keyword hash buckets */
+   int	    c;
    int	    i;
 
 
-   if (argc > 3)
-   {
-      fprintf(stderr, "usage: %s [ input [ output ] ]\n", argv[0]);
-      exit(1);
-   }
+   dense = false;
+   while ((c = getopt(argc, argv, "d")) != -1)
+      switch (c)
+      {
+	 case 'd':	/* Trade table size for scanner speed */
+	    dense = true;
+	    break;
+
+	 default:
+	    usage(argv[0]);
+      }
+   if (argc > optind + 2)
+      usage(argv[0]);
 
-   if (argc <= 1 || !strcmp(argv[1], "-"))
+   if (argc <= optind || !strcmp(argv[optind], "-"))
       input = stdin;
    else
-      if (!(input = fopen(argv[1], "r")))
+      if (!(input = fopen(argv[optind], "r")))
       {
-	 fprintf(stderr, "%s: can't open: %s\n", argv[1], strerror(errno));
+	 fprintf(stderr, "%s: can't open: %s\n", argv[optind], strerror(errno));
 	 exit(1);
       }
-   if (argc <= 2 || !strcmp(argv[2], "-"))
+   if (argc <= optind + 1 || !strcmp(argv[optind + 1], "-"))
       output = stdout;
    else
-      if (!(output = fopen(argv[2], "w")))
+      if (!(output = fopen(argv[optind + 1], "w")))
       {
-	 fprintf(stderr, "%s: can't create: %s\n", argv[2], strerror(errno));
+	 fprintf(stderr, "%s: can't create: %s\n", argv[optind + 1], strerror(errno));
 	 exit(1);
       }
 
 /* Read tables header */
 
-   fscanf(input, "%d %d %d %d %d %d %d %d %d",
-      &type, &tnumber, &ntokens, &snumber, &ntnumber,
-      &gnumber, &pnumber, &context, &defcost);
-   if (type != 0)
+   fscanf(input, "%d %d %d %d %d %d %d %d %d %d %d",
+      &type, &tnumber, &ntokens, &snumber, &cnumber, &ntnumber,
+      &gnumber, &pnumber, &context, &defcost, &lookahead);
+   if (type != 0 && type != 3)
    {
       fputs("input tables were not produced by sdtgen\n", stderr);
       exit(1);
    }
    read_name(&name, input);
 
-   fprintf(output, "1 %d %d %d %d %d %d %d %d %s\n",
-      tnumber, ntokens, snumber, ntnumber,
-      gnumber, pnumber, context, defcost,
+/* Packed tables are type 1, or type 2 if the scanner is direct indexed. */
+/* A scanner NFA is copied as type 4 whether or not -d was given	  */
+
+   fprintf(output, "%d %d %d %d %d %d %d %d %d %d %d %s\n", (type == 3) ? 4 : dense ? 2 : 1,
+      tnumber, ntokens, snumber, cnumber, ntnumber,
+      gnumber, pnumber, context, defcost, lookahead,
       &DYNARRAY(char, name, 0));
    dynfree(&name);
 
    fprintf(stderr, "Packing language with %d terminals (plus %d ignored tokens) and %d nonterminals\n",
       tnumber, ntokens - tnumber, ntnumber);
-   fprintf(stderr, "The scanner tables have %d states occupying %d x %d = %d entries\n",
-      snumber, snumber, MAPCOUNT, snumber * MAPCOUNT);
+   fprintf(stderr, "The %d input characters fall into %d equivalence classes\n",
+      MAPCOUNT, cnumber);
 
-/* Copy the end of token table index values and record the length of the table */
+/* Copy the character class map */
 
-   length = read_table(&table, snumber + 1, input);
-   write_table(table, snumber + 1, output);
+   read_table(&table, MAPCOUNT, input);
+   write_table(table, MAPCOUNT, output);
    free(table);
 
-/* Copy the concatenated end of token table */
+   if (type == 3)
+      copy_nfa(snumber, input, output);
+   else
+   {
+      fprintf(stderr, "The scanner tables have %d states occupying %d x %d = %d entries\n",
+	 snumber, snumber, cnumber, snumber * cnumber);
 
-   read_table(&table, length, input);
-   write_table(table, length, output);
-   free(table);
+/*    Copy the end of token table index values and record the length of the table */
 
-/* Copy the final state table */
+      length = read_table(&table, snumber + 1, input);
+      write_table(table, snumber + 1, output);
+      free(table);
 
-   read_table(&table, snumber, input);
-   write_table(table, snumber, output);
-   free(table);
+/*    Copy the concatenated end of token table */
 
-/* Copy scanner install flags for each state */
+      read_table(&table, length, input);
+      write_table(table, length, output);
+      free(table);
 
-   read_table(&table, snumber, input);
-   write_table(table, snumber, output);
-   free(table);
+/*    Copy the final state table */
 
-/* Compress scanner transition table */
+      read_table(&table, snumber, input);
+      write_table(table, snumber, output);
+      free(table);
 
-   load_transitions(input, snumber, &actions);
-   compare_scanner(actions, snumber, &compare);
-   compute_average(compare, snumber, &average);
-   sort_scanner(average, snumber, &index);
+/*    Copy scanner install flags for each state */
 
-/* Insert states into the compressed tables starting with the most similar to */
-/* other states and proceeding to those that are most different.  The first   */
-/* state is inserted completely with default state 0.  For the subsequent     */
-/* states find the previously inserted state which is most like the state     */
-/* being inserted and use it as the default.  Fit the transitions which	      */
-/* differ from the default state into the compressed tables using first fit.  */
-/* Finally, starting with the states that have the longest lookup chains down */
-/* to the shortest, fill in any unused table entries to prevent unnecessary   */
-/* reference to the default state					      */
+      read_table(&table, snumber, input);
+      write_table(table, snumber, output);
+      free(table);
 
-   if ((tdefault = (int *) malloc(snumber * sizeof(*tdefault))) && (tbase = (int *) malloc(snumber * sizeof(*tbase))))
-   {
-      memset(tdefault, 0, snumber * sizeof(*tdefault));
-      memset(tbase, 0, snumber * sizeof(*tbase));
-   }
-   else
-      out_of_memory();
-   dynalloc(&tcheck, sizeof(int), MAPCOUNT);
-   dynalloc(&tnext, sizeof(int), MAPCOUNT);
-   insert_scanner(actions, snumber, index[0], tdefault, tbase, &tcheck, &tnext, &chain);
-   for (i = 1; i < snumber; i++)
-      compress_scanner(actions, index, i, compare, tdefault, tbase, &tcheck, &tnext, chain);
-   if (DYNCOUNT(tcheck) != DYNCOUNT(tnext))
-   {
-      fputs("internal error\n", stderr);
-      exit(1);
-   }
-   complete_scanner(actions, snumber, tdefault, tbase, &tcheck, &tnext, chain);
-
-   fprintf(stderr, "The packed scanner tables occupy %d + %d + %d + %d = %d entries\n",
-      snumber, snumber, DYNCOUNT(tcheck), DYNCOUNT(tnext), snumber + snumber + DYNCOUNT(tcheck) + DYNCOUNT(tnext));
-   before = snumber * MAPCOUNT;
-   after  = snumber + snumber + DYNCOUNT(tcheck) + DYNCOUNT(tnext);
-   fprintf(stderr, "This is a reduction of %.1f%% in scanner table size\n", 100.0 * (before - after) / before);
-   for (total = 0.0, max = 0, i = 0; i < snumber; i++)
-   {
-      total += chain[i];
-      if (chain[i] > max)
-	 max = chain[i];
-   }
-   fprintf(stderr, "Average default state chain length is %.1f, maximum %d\n", total / snumber, max);
+/*    Copy the loop range index values and record the length of the table */
 
-/* Write out compressed scanner */
+      length = read_table(&table, snumber + 1, input);
+      write_table(table, snumber + 1, output);
+      free(table);
 
-   write_table(tdefault, snumber, output);
-   write_table(tbase, snumber, output);
-   fprintf(output, "%d\n", DYNCOUNT(tcheck));
-   write_table(&DYNARRAY(int, tcheck, 0), DYNCOUNT(tcheck), output);
-   write_table(&DYNARRAY(int, tnext, 0), DYNCOUNT(tnext), output);
+/*    Copy the concatenated loop ranges */
 
-   free(actions);
-   free(compare);
-   free(average);
-   free(index);
-   free(tdefault);
-   free(tbase);
-   dynfree(&tcheck);
-   dynfree(&tnext);
-   free(chain);
+      read_table(&table, length, input);
+      write_table(table, length, output);
+      free(table);
+
+/*    Load the scanner transition table */
+
+      load_transitions(input, snumber, cnumber, &actions);
+
+      if (dense)
+      {
+/*	 Write the transitions as a single state by class table so that	*/
+/*	 the scanner finds every transition with one direct index	*/
+
+	 fprintf(stderr, "The direct indexed scanner tables occupy %d x %d = %d entries\n",
+	    snumber, cnumber, snumber * cnumber);
+	 write_table(actions[0], snumber * cnumber, output);
+	 free(actions);
+      }
+      else
+      {
+	 compare_scanner(actions, snumber, cnumber, &compare);
+	 compute_average(compare, snumber, &average);
+	 sort_scanner(average, snumber, &index);
+
+/*	 Insert states into the compressed tables starting with the most similar to */
+/*	 other states and proceeding to those that are most different.  The first   */
+/*	 state is inserted completely with default state 0.  For the subsequent	    */
+/*	 states find the previously inserted state which is most like the state	    */
+/*	 being inserted and use it as the default.  Fit the transitions which	    */
+/*	 differ from the default state into the compressed tables using first fit.  */
+/*	 Finally, starting with the states that have the longest lookup chains down */
+/*	 to the shortest, fill in any unused table entries to prevent unnecessary   */
+/*	 reference to the default state						    */
+
+	 if ((tdefault = (int *) malloc(snumber * sizeof(*tdefault))) && (tbase = (int *) malloc(snumber * sizeof(*tbase))))
+	 {
+	    memset(tdefault, 0, snumber * sizeof(*tdefault));
+	    memset(tbase, 0, snumber * sizeof(*tbase));
+	 }
+	 else
+	    out_of_memory();
+	 dynalloc(&tcheck, sizeof(int), cnumber);
+	 dynalloc(&tnext, sizeof(int), cnumber);
+	 insert_scanner(actions, snumber, cnumber, index[0], tdefault, tbase, &tcheck, &tnext, &chain);
+	 for (i = 1; i < snumber; i++)
+	    compress_scanner(actions, cnumber, index, i, compare, tdefault, tbase, &tcheck, &tnext, chain);
+	 if (DYNCOUNT(tcheck) != DYNCOUNT(tnext))
+	 {
+	    fputs("internal error\n", stderr);
+	    exit(1);
+	 }
+	 complete_scanner(actions, snumber, cnumber, tdefault, tbase, &tcheck, &tnext, chain);
+
+	 fprintf(stderr, "The packed scanner tables occupy %d + %d + %d + %d = %d entries\n",
+	    snumber, snumber, DYNCOUNT(tcheck), DYNCOUNT(tnext), snumber + snumber + DYNCOUNT(tcheck) + DYNCOUNT(tnext));
+	 before = snumber * cnumber;
+	 after  = snumber + snumber + DYNCOUNT(tcheck) + DYNCOUNT(tnext);
+	 fprintf(stderr, "This is a reduction of %.1f%% in scanner table size\n", 100.0 * (before - after) / before);
+	 for (total = 0.0, max = 0, i = 0; i < snumber; i++)
+	 {
+	    total += chain[i];
+	    if (chain[i] > max)
+	       max = chain[i];
+	 }
+	 fprintf(stderr, "Average default state chain length is %.1f, maximum %d\n", total / snumber, max);
+
+/*	 Write out compressed scanner */
+
+	 write_table(tdefault, snumber, output);
+	 write_table(tbase, snumber, output);
+	 fprintf(output, "%d\n", DYNCOUNT(tcheck));
+	 write_table(&DYNARRAY(int, tcheck, 0), DYNCOUNT(tcheck), output);
+	 write_table(&DYNARRAY(int, tnext, 0), DYNCOUNT(tnext), output);
+
+	 free(actions);
+	 free(compare);
+	 free(average);
+	 free(index);
+	 free(tdefault);
+	 free(tbase);
+	 dynfree(&tcheck);
+	 dynfree(&tnext);
+	 free(chain);
+      }
+   }
 
    fprintf(stderr, "The parser tables have %d states occupying %d x %d = %d entries\n",
       pnumber, pnumber, tnumber + ntnumber, pnumber * (tnumber + ntnumber));
@@ -867,7 +1124,8 @@ int main
 
    copy_string(length, input, output);
 
-/* Compress parser action table */
+/* Compress the parser action table.  Only the terminal columns go into	*/
+/* the action table, the nonterminal columns form the goto table	*/
 
    load_actions(input, pnumber, tnumber + ntnumber, &count, &actions);
    sort_parser(count, pnumber, &index);
@@ -876,38 +1134,88 @@ int main
       memset(tbase, 0, pnumber * sizeof(*tbase));
    else
       out_of_memory();
-   dynalloc(&tcheck, sizeof(int), tnumber + ntnumber);
-   memset(&DYNARRAY(int, tcheck, 0), 0, (tnumber + ntnumber) * DYNELEMENT(tcheck));
-   dynalloc(&tnext, sizeof(int), tnumber + ntnumber);
-   memset(&DYNARRAY(int, tnext, 0), 0, (tnumber + ntnumber) * DYNELEMENT(tnext));
+   dynalloc(&tcheck, sizeof(int), tnumber);
+   memset(&DYNARRAY(int, tcheck, 0), 0, tnumber * DYNELEMENT(tcheck));
+   dynalloc(&tnext, sizeof(int), tnumber);
+   memset(&DYNARRAY(int, tnext, 0), 0, tnumber * DYNELEMENT(tnext));
    for (i = 0; i < pnumber; i++)
-      compress_parser(actions, index[i], tnumber + ntnumber, tbase, &tcheck, &tnext);
+      compress_parser(actions, index[i], tnumber, tbase, &tcheck, &tnext);
    if (DYNCOUNT(tcheck) != DYNCOUNT(tnext))
    {
       fputs("internal error\n", stderr);
       exit(1);
    }
 
-   fprintf(stderr, "The packed parser tables occupy %d + %d + %d = %d entries\n",
+   fprintf(stderr, "The packed parser action tables occupy %d + %d + %d = %d entries\n",
       pnumber, DYNCOUNT(tcheck), DYNCOUNT(tnext), pnumber + DYNCOUNT(tcheck) + DYNCOUNT(tnext));
    before = pnumber * (tnumber + ntnumber);
    after  = pnumber + DYNCOUNT(tcheck) + DYNCOUNT(tnext);
-   fprintf(stderr, "This is a reduction of %.1f%% in parser table size\n", 100.0 * (before - after) / before);
 
-/* Write out compressed parser */
+/* Write out compressed parser actions */
 
    write_table(tbase, pnumber, output);
    fprintf(output, "%d\n", DYNCOUNT(tcheck));
    write_table(&DYNARRAY(int, tcheck, 0), DYNCOUNT(tcheck), output);
    write_table(&DYNARRAY(int, tnext, 0), DYNCOUNT(tnext), output);
 
+   free(count);
+   free(index);
+   free(tbase);
+   dynfree(&tcheck);
+   dynfree(&tnext);
+
+/* Compress the goto table by nonterminal column in the same way, after */
+/* removing the entries which each column's default supplies		*/
+
+   if ((tdefault = (int *) malloc(ntnumber * sizeof(*tdefault))) && (tbase = (int *) malloc(ntnumber * sizeof(*tbase))))
+      memset(tbase, 0, ntnumber * sizeof(*tbase));
+   else
+      out_of_memory();
+   split_gotos(actions, pnumber, tnumber, ntnumber, tdefault, &count, &gotos);
+   sort_parser(count, ntnumber, &index);
+
+   dynalloc(&tcheck, sizeof(int), pnumber);
+   memset(&DYNARRAY(int, tcheck, 0), 0, pnumber * DYNELEMENT(tcheck));
+   dynalloc(&tnext, sizeof(int), pnumber);
+   memset(&DYNARRAY(int, tnext, 0), 0, pnumber * DYNELEMENT(tnext));
+   for (i = 0; i < ntnumber; i++)
+      compress_parser(gotos, index[i], pnumber, tbase, &tcheck, &tnext);
+   if (DYNCOUNT(tcheck) != DYNCOUNT(tnext))
+   {
+      fputs("internal error\n", stderr);
+      exit(1);
+   }
+
+   fprintf(stderr, "The packed parser goto tables occupy %d + %d + %d + %d = %d entries\n",
+      ntnumber, ntnumber, DYNCOUNT(tcheck), DYNCOUNT(tnext), ntnumber + ntnumber + DYNCOUNT(tcheck) + DYNCOUNT(tnext));
+   after += ntnumber + ntnumber + DYNCOUNT(tcheck) + DYNCOUNT(tnext);
+   fprintf(stderr, "This is a reduction of %.1f%% in parser table size\n", 100.0 * (before - after) / before);
+
+/* Write out compressed parser gotos */
+
+   write_table(tdefault, ntnumber, output);
+   write_table(tbase, ntnumber, output);
+   fprintf(output, "%d\n", DYNCOUNT(tcheck));
+   write_table(&DYNARRAY(int, tcheck, 0), DYNCOUNT(tcheck), output);
+   write_table(&DYNARRAY(int, tnext, 0), DYNCOUNT(tnext), output);
+
    free(count);
    free(actions);
+   free(gotos);
    free(index);
+   free(tdefault);
    free(tbase);
    dynfree(&tcheck);
    dynfree(&tnext);
 
+/* Copy the keywords found by lookup if there are any */
+
+   if (fscanf(input, "%d %d %d", &keywords, &buckets, &length) == 3)
+   {
+      fprintf(output, "%d %d %d\n", keywords, buckets, length);
+      copy_keywords(keywords, buckets, input, output);
+   }
+
    fclose(input);
    fclose(output);
    exit(0);
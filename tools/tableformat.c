@@ -17,11 +17,15 @@
 /* with this program.  If not, see <https://www.gnu.org/licenses/>.	      */
 
 #include <errno.h>
+#include <limits.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
 #include "dynarray_definitions.h"
+#include "scangen_definitions.h"
 #include "sdtgen_definitions.h"
 
 #include "dynarray_functions.h"
@@ -32,12 +36,56 @@
 #define INITIAL_NAME_SIZE	8
 
 
+static int *expand_scanner(int, int, int *, int *, int *, int *);
 static void format_string(int, char *, FILE *, FILE *);
 static void read_name(dynarray *, FILE *);
 static int  read_table(int **, int, FILE *);
+static void usage(char *);
+static void write_cases(int *, int, int, int, bool *, FILE *);
+static void write_keywords(int, int, int, int, FILE *, FILE *);
+static char *write_narrow(int *, int, int, char *, FILE *);
+static void write_nfa(int, int, FILE *, FILE *);
+static void write_parser(int, int, int, int *, int *, int *, int *, int *, int *, int *, FILE *);
+static void write_scanner(int, int, int, int *, int *, int *, int *, int *, FILE *);
+static void write_states(int, int *, int *, int *, int *, int *, int *, FILE *);
 static void write_table(int *, int, int, char *, FILE *);
 
 
+static int *expand_scanner
+(
+   int	snumber,
+   int	cnumber,
+   int *sdefault,
+   int *sbase,
+   int *scheck,
+   int *snext
+)
+{
+/* Expand the packed scanner tables into a full state by class table */
+
+   int *delta;
+   int	state;
+   int	i, j;
+
+   if (!(delta = (int *) malloc(snumber * cnumber * sizeof(*delta))))
+      out_of_memory();
+
+   for (i = 0; i < snumber; i++)
+      for (j = 0; j < cnumber; j++)
+	 if (!scheck)
+	    delta[i * cnumber + j] = snext[i * cnumber + j];
+	 else
+	 {
+/*	    Follow the default state chain until a valid transition is found */
+
+	    for (state = i + 1; state && scheck[sbase[state - 1] + j] != state; state = sdefault[state - 1])
+	       ;
+	    delta[i * cnumber + j] = state ? snext[sbase[state - 1] + j] : 0;
+	 }
+   return(delta);
+}
+
+
 static void format_string
 (
    int	 count,
@@ -153,7 +201,529 @@ static int read_table
       out_of_memory();
    for (i = 0; i < size; i++)
       fscanf(fp, "%d", &(*table)[i]);
-   return((*table)[size - 1]);
+   return(size ? (*table)[size - 1] : 0);
+}
+
+
+static void usage
+(
+   char *argv0
+)
+{
+   fprintf(stderr, "usage: %s [-c] [-f] [-p] [ input [ output ] ]\n", argv0);
+   exit(1);
+}
+
+
+static void write_cases
+(
+   int	*entry,
+   int	 first,
+   int	 last,
+   int	 indent,
+   bool *done,
+   FILE *fp
+)
+{
+/* Write the switch cases returning the non-zero entries for tokens first */
+/* through last, indented by indent columns using tabs where possible.	  */
+/* The tokens which share an entry form one case list			  */
+
+   int length;
+   int i, j;
+
+   for (i = first; i <= last; i++)
+      if (!done[i] && entry[i])
+      {
+	 for (length = 0, j = i; j <= last; j++)
+	    if (!done[j] && entry[j] == entry[i])
+	    {
+	       done[j] = true;
+	       if (length && length + 6 + digit_count(j) + 1 > MAXLINE)
+	       {
+		  fputc('\n', fp);
+		  length = 0;
+	       }
+	       if (length)
+		  length += fprintf(fp, " case %d:", j);
+	       else
+	       {
+		  fprintf(fp, "%.*s%*s", indent / 8, "\t\t\t\t", indent % 8, "");
+		  length = indent + fprintf(fp, "case %d:", j);
+	       }
+	    }
+	 fprintf(fp, "\n%.*s%*sreturn(%d);\n", (indent + 3) / 8, "\t\t\t\t", (indent + 3) % 8, "", entry[i]);
+      }
+}
+
+
+static void write_keywords
+(
+   int	 count,
+   int	 buckets,
+   int	 longest,
+   int	 ntokens,
+   FILE *input,
+   FILE *fp
+)
+{
+/* Write the perfect hash table of keywords found by lookup, along with */
+/* a flag for each token telling whether its string may be a keyword	*/
+
+   int *table;
+   int *check;
+   int	length;
+   int	i;
+
+/* Format the bucket seeds */
+
+   read_table(&table, buckets, input);
+   write_table(table, buckets, 0, "int Kwseed", fp);
+   free(table);
+
+/* Format the token and base token of each slot, noting each base token */
+
+   read_table(&table, count, input);
+   write_table(table, count, 0, "int Kwtoken", fp);
+   free(table);
+
+   if (!(check = (int *) calloc(ntokens + 1, sizeof(*check))))
+      out_of_memory();
+   read_table(&table, count, input);
+   write_table(table, count, 0, "int Kwbase", fp);
+   for (i = 0; i < count; i++)
+      check[table[i]] = 1;
+   free(table);
+
+/* Format the install and case insignificance flags of each slot */
+
+   read_table(&table, count, input);
+   write_table(table, count, 0, "char Kwinstall", fp);
+   free(table);
+
+   read_table(&table, count, input);
+   write_table(table, count, 0, "char Kwfold", fp);
+   free(table);
+
+/* Format the keyword name index and the concatenated names */
+
+   length = read_table(&table, count + 1, input);
+   write_table(table, count + 1, 0, "int Kwnameindex", fp);
+   free(table);
+
+   format_string(length, "Kwnametable", input, fp);
+
+   write_table(check, ntokens + 1, 0, "char Kwcheck", fp);
+   free(check);
+
+   fputs("static keywordentry Keywords =\n", fp);
+   fputs("{\n", fp);
+   fprintf(fp, "   %d, %d, %d, Kwseed, Kwtoken, Kwbase, Kwinstall, Kwfold,\n", count, buckets, longest);
+   fputs("   Kwnameindex, Kwnametable, Kwcheck\n", fp);
+   fputs("};\n\n", fp);
+}
+
+
+static char *write_narrow
+(
+   int	*table,
+   int	 size,
+   int	 base,
+   char *name,
+   FILE *fp
+)
+{
+/* Write a packed table in the narrowest integer type that holds all of */
+/* its values, and return the name of the constant for that type	*/
+
+   char define[32];		/* Type and name of the table */
+   int	min;			/* Smallest value in the table */
+   int	max;			/* Largest value in the table */
+   int	i;
+
+   for (min = max = 0, i = 0; i < size; i++)
+      if (table[i] < min)
+	 min = table[i];
+      else if (table[i] > max)
+	 max = table[i];
+
+   if (min >= 0 && max <= UINT8_MAX)
+   {
+      snprintf(define, sizeof(define), "uint8_t %s", name);
+      write_table(table, size, base, define, fp);
+      return("UINT8_TABLE");
+   }
+   else if (min >= 0 && max <= UINT16_MAX)
+   {
+      snprintf(define, sizeof(define), "uint16_t %s", name);
+      write_table(table, size, base, define, fp);
+      return("UINT16_TABLE");
+   }
+   else if (min >= INT16_MIN && max <= INT16_MAX)
+   {
+      snprintf(define, sizeof(define), "int16_t %s", name);
+      write_table(table, size, base, define, fp);
+      return("INT16_TABLE");
+   }
+   else
+   {
+      snprintf(define, sizeof(define), "int32_t %s", name);
+      write_table(table, size, base, define, fp);
+      return("INT32_TABLE");
+   }
+}
+
+
+static void write_nfa
+(
+   int	 snumber,
+   int	 cnumber,
+   FILE *input,
+   FILE *fp
+)
+{
+/* Write the scanner NFA from which the parser builds its DFA lazily.	*/
+/* The classes on which each position has a transition are written as	*/
+/* one row of bits per position, with an empty row for position 0	*/
+
+   int *start;
+   int *table;
+   int *index;
+   int *bits;
+   int	stride;
+   int	length;
+   int	i, j;
+
+/* Format the first positions preceded by their count */
+
+   fscanf(input, "%d", &length);
+   if (!(start = (int *) malloc((length + 1) * sizeof(*start))))
+      out_of_memory();
+   start[0] = length;
+   for (i = 1; i <= length; i++)
+      fscanf(input, "%d", &start[i]);
+   write_table(start, length + 1, 0, "int Nfastart", fp);
+   free(start);
+
+/* Format the end of token, final, and install values of each position */
+
+   read_table(&table, snumber, input);
+   write_table(table, snumber, 1, "int Nfatoken", fp);
+   free(table);
+
+   read_table(&table, snumber, input);
+   write_table(table, snumber, 1, "int Nfafinal", fp);
+   free(table);
+
+   read_table(&table, snumber, input);
+   write_table(table, snumber, 1, "char Nfainstall", fp);
+   free(table);
+
+/* Format the transition classes of each position as a bitmap */
+
+   length = read_table(&index, snumber + 1, input);
+   read_table(&table, length, input);
+
+   stride = (cnumber + 7) / 8;
+   if (!(bits = (int *) malloc((snumber + 1) * stride * sizeof(*bits))))
+      out_of_memory();
+   memset(bits, 0, (snumber + 1) * stride * sizeof(*bits));
+   for (i = 0; i < snumber; i++)
+      for (j = index[i]; j < index[i + 1]; j++)
+	 bits[(i + 1) * stride + table[j] / 8] |= 1 << table[j] % 8;
+   write_table(bits, (snumber + 1) * stride, 0, "unsigned char Nfaclass", fp);
+   free(index);
+   free(table);
+   free(bits);
+
+/* Format the follow set index and the concatenated follow sets */
+
+   length = read_table(&table, snumber + 1, input);
+   write_table(table, snumber + 1, 1, "int Nfafollowindex", fp);
+   free(table);
+
+   read_table(&table, length, input);
+   write_table(table, length, 0, "int Nfafollow", fp);
+   free(table);
+
+   fputs("static nfaentry Nfa =\n", fp);
+   fputs("{\n", fp);
+   fprintf(fp, "   %d, %d, Nfastart, Nfatoken, Nfafinal, Nfainstall,\n", snumber, cnumber);
+   fputs("   Nfaclass, Nfafollowindex, Nfafollow\n", fp);
+   fputs("};\n\n", fp);
+}
+
+
+static void write_parser
+(
+   int	 pnumber,
+   int	 tnumber,
+   int	 ntnumber,
+   int	*pbase,
+   int	*pcheck,
+   int	*pnext,
+   int	*gdefault,
+   int	*gbase,
+   int	*gcheck,
+   int	*gnext,
+   FILE *fp
+)
+{
+/* Write the parser automaton as C code.  Each state switches on the	   */
+/* token to return the table entry which decode_action or decode_goto	   */
+/* would have found for it.  A goto which a state takes from the default   */
+/* of its nonterminal column is returned by a final switch on the token,   */
+/* and any other token has no entry					   */
+
+   int	*entry;			/* Table entry for each token in a state */
+   bool *done;			/* Token has been written as a case */
+   int	 state;
+   int	 i, k;
+
+   if (!(entry = (int *) malloc((tnumber + ntnumber + 1) * sizeof(*entry))) ||
+       !(done = (bool *) malloc((tnumber + ntnumber + 1) * sizeof(*done))))
+      out_of_memory();
+
+   fputs("static int Parser\n", fp);
+   fputs("(\n", fp);
+   fputs("   int state,\n", fp);
+   fputs("   int token\n", fp);
+   fputs(")\n", fp);
+   fputs("{\n", fp);
+   fputs("   switch (state)\n", fp);
+   fputs("   {\n", fp);
+
+   for (state = 1; state <= pnumber; state++)
+   {
+/*    Gather the actions and the gotos kept apart from the column defaults */
+
+      for (i = 1; i <= tnumber; i++)
+	 entry[i] = (pcheck[(k = pbase[state - 1] + i) - 1] == state) ? pnext[k - 1] : 0;
+      for (i = 1; i <= ntnumber; i++)
+	 entry[tnumber + i] = (gcheck[(k = gbase[i - 1] + state) - 1] == i) ? gnext[k - 1] : 0;
+
+      for (i = 1; i <= tnumber + ntnumber && !entry[i]; i++)
+	 ;
+      if (i > tnumber + ntnumber)
+	 continue;
+
+      memset(done, false, (tnumber + ntnumber + 1) * sizeof(*done));
+      fprintf(fp, "      case %d:\n", state);
+      fputs("\t switch (token)\n", fp);
+      fputs("\t {\n", fp);
+      write_cases(entry, 1, tnumber + ntnumber, 12, done, fp);
+      fputs("\t }\n", fp);
+      fputs("\t break;\n", fp);
+   }
+   fputs("   }\n\n", fp);
+
+/* Every other goto is the default of its nonterminal's column */
+
+   memset(done, false, (tnumber + ntnumber + 1) * sizeof(*done));
+   for (i = 1; i <= ntnumber; i++)
+      entry[tnumber + i] = gdefault[i - 1];
+   fputs("   switch (token)\n", fp);
+   fputs("   {\n", fp);
+   write_cases(entry, tnumber + 1, tnumber + ntnumber, 6, done, fp);
+   fputs("   }\n", fp);
+   fputs("   return(0);\n", fp);
+   fputs("}\n\n", fp);
+   free(entry);
+   free(done);
+}
+
+
+static void write_scanner
+(
+   int	 snumber,
+   int	 cnumber,
+   int	 lookahead,
+   int	*classmap,
+   int	*tokenindex,
+   int	*tokentable,
+   int	*final,
+   int	*delta,
+   FILE *fp
+)
+{
+/* Write the scanner automaton as C code.  Each state records its end of */
+/* token and final values and then switches on the input character to   */
+/* the code for the next state.  The function returns the last final	*/
+/* state encountered just as the table driven scanner in input_token	*/
+/* does									*/
+
+   bool	*target;		/* State is the target of some transition */
+   int	*count;			/* Number of characters leading to each state */
+   int	 common;		/* Next state for the most characters */
+   bool	 done[MAPCOUNT];	/* Character has been written as a case */
+   int	 next;			/* Next state for the current character */
+   bool	 switched = false;	/* Switch statement has been started */
+   int	 length;
+   int	 i, j, k;
+
+/* Only states which some transition leads to need a label */
+
+   if (target = (bool *) malloc((snumber + 1) * sizeof(*target)))
+      memset(target, false, (snumber + 1) * sizeof(*target));
+   else
+      out_of_memory();
+   if (!(count = (int *) malloc((snumber + 1) * sizeof(*count))))
+      out_of_memory();
+   for (i = 0; i < snumber * cnumber; i++)
+      target[delta[i]] = true;
+
+   fputs("static int Scanner\n", fp);
+   fputs("(\n", fp);
+   fputs("   sdt_tables *tables,\n", fp);
+   fputs("   int\t       ch,\n", fp);
+   fputs("   location   *where\n", fp);
+   fputs(")\n", fp);
+   fputs("{\n", fp);
+   fputs("   int final = -1;\n", fp);
+
+   for (i = 1; i <= snumber; i++)
+   {
+      fputc('\n', fp);
+      if (target[i])
+	 fprintf(fp, "S%d:\n", i);
+
+/*    Record the end of token values and final state as input_token would. */
+/*    Without lookahead expressions only the final token's end is needed    */
+
+      if (lookahead)
+	 for (j = tokenindex[i - 1]; j < tokenindex[i]; j++)
+	    fprintf(fp, "   tables->tokenend[%d] = *where;\n", tokentable[j]);
+      else if (final[i - 1])
+	 fprintf(fp, "   tables->tokenend[%d] = *where;\n", final[i - 1]);
+      if (final[i - 1])
+	 fprintf(fp, "   final = %d;\n", i);
+
+/*    The next state reached by the most characters becomes the default */
+
+      memset(count, 0, (snumber + 1) * sizeof(*count));
+      for (j = 0; j < MAPCOUNT; j++)
+	 count[delta[(i - 1) * cnumber + classmap[j]]]++;
+      for (common = 0, j = 1; j <= snumber; j++)
+	 if (count[j] > count[common])
+	    common = j;
+
+/*    Write one case list for all the characters leading to each other */
+/*    next state, including no state at all if there is a default      */
+
+      memset(done, false, sizeof(done));
+      for (j = 0; j < MAPCOUNT; j++)
+      {
+	 next = delta[(i - 1) * cnumber + classmap[j]];
+	 if (!done[j] && next != common)
+	 {
+	    if (!switched)
+	    {
+	       fputs("   switch (ch)\n", fp);
+	       fputs("   {\n", fp);
+	       switched = true;
+	    }
+	    for (length = 0, k = j; k < MAPCOUNT; k++)
+	       if (!done[k] && delta[(i - 1) * cnumber + classmap[k]] == next)
+	       {
+		  done[k] = true;
+		  if (length && length + 6 + digit_count(k) + 1 > MAXLINE)
+		  {
+		     fputc('\n', fp);
+		     length = 0;
+		  }
+		  if (length)
+		     length += fprintf(fp, " case %d:", k);
+		  else
+		     length = fprintf(fp, "      case %d:", k);
+	       }
+	    fputc('\n', fp);
+	    if (next)
+	    {
+	       fputs("\t ch = scan_char(tables, where);\n", fp);
+	       fprintf(fp, "\t goto S%d;\n", next);
+	    }
+	    else
+	       fputs("\t return(final);\n", fp);
+	 }
+      }
+
+/*    Finally write the transition to the default next state */
+
+      if (common)
+      {
+	 if (switched)
+	 {
+	    fputs("      default:\n", fp);
+	    fputs("\t ch = scan_char(tables, where);\n", fp);
+	    fprintf(fp, "\t goto S%d;\n", common);
+	 }
+	 else
+	 {
+	    fputs("   ch = scan_char(tables, where);\n", fp);
+	    fprintf(fp, "   goto S%d;\n", common);
+	 }
+      }
+      if (switched)
+      {
+	 fputs("   }\n", fp);
+	 switched = false;
+      }
+      if (!common)
+	 fputs("   return(final);\n", fp);
+   }
+   fputs("}\n\n", fp);
+   free(target);
+   free(count);
+}
+
+
+static void write_states
+(
+   int	 snumber,
+   int	*tokenindex,
+   int	*final,
+   int	*install,
+   int	*loopindex,
+   int	*sdefault,
+   int	*sbase,
+   FILE *fp
+)
+{
+/* Write the per state scanner data that input_token reads as one fused */
+/* entry for each state.  The final token and the number of end of token */
+/* values must fit in the narrower fields of the entry			 */
+
+   int width[4];		/* Width of each numeric field */
+   int i;
+
+   memset(width, 0, sizeof(width));
+   for (i = 0; i < snumber; i++)
+   {
+      if (final[i] > SHRT_MAX || tokenindex[i + 1] - tokenindex[i] > UCHAR_MAX)
+      {
+	 fprintf(stderr, "scanner state %d does not fit in a fused state entry\n", i + 1);
+	 exit(1);
+      }
+      if (sbase[i] > width[0])
+	 width[0] = sbase[i];
+      if (sdefault && sdefault[i] > width[1])
+	 width[1] = sdefault[i];
+      if (tokenindex[i] > width[2])
+	 width[2] = tokenindex[i];
+      if (final[i] > width[3])
+	 width[3] = final[i];
+   }
+   for (i = 0; i < 4; i++)
+      width[i] = digit_count(width[i]);
+
+   fprintf(fp, "static stateentry Scanstate[%d] =\n", snumber + 1);
+   fputs("{\n", fp);
+   fprintf(fp, "   {%*d, %*d, %*d, %*d, %3d, false},\n", width[0], 0, width[1], 0, width[2], 0, width[3], 0, 0);
+   for (i = 0; i < snumber; i++)
+      fprintf(fp, "   {%*d, %*d, %*d, %*d, %3d, %s}%s\n", width[0], sbase[i], width[1], sdefault ? sdefault[i] : 0,
+	 width[2], tokenindex[i], width[3], final[i], tokenindex[i + 1] - tokenindex[i],
+	 (loopindex[i] < loopindex[i + 1]) ? "true" : "false", (i < snumber - 1) ? "," : "");
+   fputs("};\n\n", fp);
 }
 
 
@@ -259,104 +829,194 @@ int main
 {
    FILE	   *input;
    FILE	   *output;
-   int	    type;		/* Table type (1 for compressed tables */
+   int	    type;		/* Table type (1 for compressed tables, 2 for direct indexed scanner, 4 for NFA */
    int	    tnumber;		/* Number of terminals in the language */
    int	    ntokens;		/* Number of tokens including ignored */
    int	    snumber;		/* Number of states in the scanner */
+   int	    cnumber;		/* Number of input character classes */
    int	    ntnumber;		/* Number of nonterminals in the language */
    int	    gnumber;		/* Number of productions in the grammar */
    int	    pnumber;		/* Number of states in the parser */
    int	    context;		/* Number of error repair context tokens */
    int	    defcost;		/* Assumed cost to repair a single error */
+   int	    lookahead;		/* Nonzero if any token has a lookahead */
    dynarray name;		/* Identifying name for tables */
    int	   *table;		/* Generic table of integer values */
    int	    length;		/* Table length returned by index table */
+   bool	    code = false;	/* True if the scanner is written as C code */
+   bool	    fused = false;	/* True if the per state scanner data is fused */
+   bool	    parser = false;	/* True if the parser is written as C code */
+   int	   *classmap;		/* Tables kept to write the scanner code */
+   int	   *tokenindex = NULL;
+   int	   *tokentable = NULL;
+   int	   *final = NULL;
+   int	   *install = NULL;
+   int	   *loopindex = NULL;
+   int	   *sdefault = NULL;
+   int	   *sbase = NULL;
+   int	   *scheck = NULL;
+   int	   *snext = NULL;
+   int	   *delta;
+   int	   *pbase;		/* Tables kept to write the parser code */
+   int	   *pcheck;
+   int	   *pnext;
+   int	   *gdefault;
+   int	   *gbase;
+   int	   *gcheck;
+   int	   *gnext;
+   char	   *stype[4];		/* Types of the packed scanner and parser tables */
+   char	   *ptype[3];
+   char	   *gtype[4];
+   int	    keywords = 0;	/* Number of keywords found by lookup */
+   int	    buckets;		/* Number of keyword hash buckets */
+   char	   *tail[5];		/* Optional tables at the end of the definition */
+   int	    last;		/* Number of optional tables written */
+   int	    c;
+   int	    i;
+
+   while ((c = getopt(argc, argv, "cfp")) != -1)
+      switch (c)
+      {
+	 case 'c':
+	    code = true;
+	    break;
 
-   if (argc > 3)
-   {
-      fprintf(stderr, "usage: %s [ input [ output ] ]\n", argv[0]);
-      exit(1);
-   }
+	 case 'f':
+	    fused = true;
+	    break;
 
-   if (argc <= 1 || !strcmp(argv[1], "-"))
+	 case 'p':
+	    parser = true;
+	    break;
+
+	 default:
+	    usage(argv[0]);
+      }
+   if (argc > optind + 2)
+      usage(argv[0]);
+
+   if (argc <= optind || !strcmp(argv[optind], "-"))
       input = stdin;
    else
-      if (!(input = fopen(argv[1], "r")))
+      if (!(input = fopen(argv[optind], "r")))
       {
-	 fprintf(stderr, "%s: can't open: %s\n", argv[1], strerror(errno));
+	 fprintf(stderr, "%s: can't open: %s\n", argv[optind], strerror(errno));
 	 exit(1);
       }
-   if (argc <= 2 || !strcmp(argv[2], "-"))
+   if (argc <= optind + 1 || !strcmp(argv[optind + 1], "-"))
       output = stdout;
    else
-      if (!(output = fopen(argv[2], "w")))
+      if (!(output = fopen(argv[optind + 1], "w")))
       {
-	 fprintf(stderr, "%s: can't create: %s\n", argv[2], strerror(errno));
+	 fprintf(stderr, "%s: can't create: %s\n", argv[optind + 1], strerror(errno));
 	 exit(1);
       }
 
 /* Read tables header */
 
-   fscanf(input, "%d %d %d %d %d %d %d %d %d",
-      &type, &tnumber, &ntokens, &snumber, &ntnumber,
-      &gnumber, &pnumber, &context, &defcost);
-   if (type != 1)
+   fscanf(input, "%d %d %d %d %d %d %d %d %d %d %d",
+      &type, &tnumber, &ntokens, &snumber, &cnumber, &ntnumber,
+      &gnumber, &pnumber, &context, &defcost, &lookahead);
+   if (type != 1 && type != 2 && type != 4)
    {
       fputs("input tables were not produced by packtables\n", stderr);
       exit(1);
    }
+   if (type == 4 && (code || fused))
+   {
+      fputs("the -c and -f options require a scanner DFA\n", stderr);
+      exit(1);
+   }
    read_name(&name, input);
 
+   if (type == 2 || type == 4 || fused && !code)
+      fputs("#include <stddef.h>\n\n", output);
    fputs("#include \"tables_definitions.h\"\n\n", output);
+   if (code)
+      fputs("#include \"parser_functions.h\"\n\n", output);
 
-/* Format end of token index table */
+/* Format character class map */
 
-   length = read_table(&table, snumber + 1, input);
-   write_table(table, snumber + 1, 1, "int Tokenindex", output);
-   free(table);
+   read_table(&classmap, MAPCOUNT, input);
+   write_table(classmap, MAPCOUNT, 0, "int Classmap", output);
 
-/* Format the concatenated end of token table */
+/* Format the scanner NFA, or the scanner DFA tables */
 
-   read_table(&table, length, input);
-   write_table(table, length, 0, "int Tokentable", output);
-   free(table);
+   if (type == 4)
+      write_nfa(snumber, cnumber, input, output);
+   else
+   {
+/*    Format end of token index table */
 
-/* Format final state table */
+      length = read_table(&tokenindex, snumber + 1, input);
+      write_table(tokenindex, snumber + 1, 1, "int Tokenindex", output);
 
-   read_table(&table, snumber, input);
-   write_table(table, snumber, 1, "int Final", output);
-   free(table);
+/*    Format the concatenated end of token table */
 
-/* Format scanner install flag table */
+      read_table(&tokentable, length, input);
+      write_table(tokentable, length, 0, "int Tokentable", output);
 
-   read_table(&table, snumber, input);
-   write_table(table, snumber, 1, "char Install", output);
-   free(table);
+/*    Format final state table */
 
-/* Format scanner default state table */
+      read_table(&final, snumber, input);
+      write_table(final, snumber, 1, "int Final", output);
 
-   read_table(&table, snumber, input);
-   write_table(table, snumber, 1, "int Sdefault", output);
-   free(table);
+/*    Format scanner install flag table */
 
-/* Format scanner base index table */
+      read_table(&install, snumber, input);
+      write_table(install, snumber, 1, "char Install", output);
 
-   read_table(&table, snumber, input);
-   write_table(table, snumber, 1, "int Sbase", output);
-   free(table);
+/*    Format loop range index table */
 
-/* Format scanner check state table */
+      length = read_table(&loopindex, snumber + 1, input);
+      write_table(loopindex, snumber + 1, 1, "int Loopindex", output);
 
-   fscanf(input, "%d", &length);
-   read_table(&table, length, input);
-   write_table(table, length, 0, "int Scheck", output);
-   free(table);
+/*    Format the concatenated loop ranges */
 
-/* Format scanner next state table */
+      read_table(&table, length, input);
+      write_table(table, length, 0, "int Looptable", output);
+      free(table);
 
-   read_table(&table, length, input);
-   write_table(table, length, 0, "int Snext", output);
-   free(table);
+      if (type == 2)
+      {
+/*	 A direct indexed scanner has no default or check tables.  Each */
+/*	 state's base index is simply the start of its row of classes   */
+
+	 if (!(sbase = (int *) malloc(snumber * sizeof(*sbase))))
+	    out_of_memory();
+	 for (i = 0; i < snumber; i++)
+	    sbase[i] = i * cnumber;
+	 stype[1] = write_narrow(sbase, snumber, 1, "Sbase", output);
+
+/*	 Format scanner next state table */
+
+	 read_table(&snext, snumber * cnumber, input);
+	 stype[3] = write_narrow(snext, snumber * cnumber, 0, "Snext", output);
+      }
+      else
+      {
+/*	 Format scanner default state table */
+
+	 read_table(&sdefault, snumber, input);
+	 stype[0] = write_narrow(sdefault, snumber, 1, "Sdefault", output);
+
+/*	 Format scanner base index table */
+
+	 read_table(&sbase, snumber, input);
+	 stype[1] = write_narrow(sbase, snumber, 1, "Sbase", output);
+
+/*	 Format scanner check state table */
+
+	 fscanf(input, "%d", &length);
+	 read_table(&scheck, length, input);
+	 stype[2] = write_narrow(scheck, length, 0, "Scheck", output);
+
+/*	 Format scanner next state table */
+
+	 read_table(&snext, length, input);
+	 stype[3] = write_narrow(snext, length, 0, "Snext", output);
+      }
+   }
 
 /* Format terminal insertion costs */
 
@@ -406,33 +1066,126 @@ int main
 
 /* Format parser base index table */
 
-   read_table(&table, pnumber, input);
-   write_table(table, pnumber, 1, "int Pbase", output);
-   free(table);
+   read_table(&pbase, pnumber, input);
+   ptype[0] = write_narrow(pbase, pnumber, 1, "Pbase", output);
 
 /* Format parser check state table */
 
    fscanf(input, "%d", &length);
-   read_table(&table, length, input);
-   write_table(table, length, 1, "int Pcheck", output);
-   free(table);
+   read_table(&pcheck, length, input);
+   ptype[1] = write_narrow(pcheck, length, 1, "Pcheck", output);
 
 /* Format parser next state table */
 
-   read_table(&table, length, input);
-   write_table(table, length, 1, "int Pnext", output);
-   free(table);
+   read_table(&pnext, length, input);
+   ptype[2] = write_narrow(pnext, length, 1, "Pnext", output);
+
+/* Format goto default table */
+
+   read_table(&gdefault, ntnumber, input);
+   gtype[0] = write_narrow(gdefault, ntnumber, 1, "Gdefault", output);
+
+/* Format goto base index table */
+
+   read_table(&gbase, ntnumber, input);
+   gtype[1] = write_narrow(gbase, ntnumber, 1, "Gbase", output);
+
+/* Format goto check nonterminal table */
+
+   fscanf(input, "%d", &length);
+   read_table(&gcheck, length, input);
+   gtype[2] = write_narrow(gcheck, length, 1, "Gcheck", output);
+
+/* Format goto next state table */
+
+   read_table(&gnext, length, input);
+   gtype[3] = write_narrow(gnext, length, 1, "Gnext", output);
+
+/* Format the keywords found by lookup if there are any */
+
+   if (fscanf(input, "%d %d %d", &keywords, &buckets, &length) == 3)
+      write_keywords(keywords, buckets, length, ntokens, input, output);
+   else
+      keywords = 0;
+
+/* If requested, write the scanner automaton as a C function */
+
+   if (code)
+   {
+      delta = expand_scanner(snumber, cnumber, sdefault, sbase, scheck, snext);
+      write_scanner(snumber, cnumber, lookahead, classmap, tokenindex, tokentable, final, delta, output);
+      free(delta);
+   }
+
+/* If requested, write the parser automaton as a C function */
+
+   if (parser)
+      write_parser(pnumber, tnumber, ntnumber, pbase, pcheck, pnext, gdefault, gbase, gcheck, gnext, output);
+   free(pbase);
+   free(pcheck);
+   free(pnext);
+   free(gdefault);
+   free(gbase);
+   free(gcheck);
+   free(gnext);
+
+/* If requested, gather the per state scanner data into one table */
+
+   if (fused)
+      write_states(snumber, tokenindex, final, install, loopindex, sdefault, sbase, output);
+   free(classmap);
+   free(tokenindex);
+   free(tokentable);
+   free(final);
+   free(install);
+   free(loopindex);
+   free(sdefault);
+   free(sbase);
+   free(scheck);
+   free(snext);
 
 /* Finally, write the variable definition for all of the above */
 
    fprintf(output, "sdt_tables %s =\n", &DYNARRAY(char, name, 0));
    fputs("{\n", output);
-   fprintf(output, "   %d, %d, %d, %d, %d,\n", ntokens, tnumber, ntnumber, context, defcost);
-   fputs("   Tokenindex, Tokentable, Final, Install,\n", output);
-   fputs("   Sdefault, Sbase, Scheck, Snext,\n", output);
+   fprintf(output, "   %d, %d, %d, %d, %d, %s,\n", ntokens, tnumber, ntnumber, context, defcost, lookahead ? "true" : "false");
+   if (type == 4)
+      fputs("   NULL, NULL, NULL, NULL,\n", output);
+   else
+      fputs("   Tokenindex, Tokentable, Final, Install,\n", output);
+   if (type == 4)
+      fputs("   Classmap, {0, NULL}, {0, NULL}, {0, NULL}, {0, NULL},\n", output);
+   else if (type == 2)
+      fprintf(output, "   Classmap, {0, NULL}, {%s, Sbase}, {0, NULL}, {%s, Snext},\n", stype[1], stype[3]);
+   else
+      fprintf(output, "   Classmap, {%s, Sdefault}, {%s, Sbase},\n   {%s, Scheck}, {%s, Snext},\n",
+	 stype[0], stype[1], stype[2], stype[3]);
+   if (type == 4)
+      fputs("   NULL, NULL,\n", output);
+   else
+      fputs("   Loopindex, Looptable,\n", output);
    fputs("   Inscost, Delcost, Lhstoken, Rhslength, Semantics,\n", output);
    fputs("   Repair, Stringindex, Stringtable,\n", output);
-   fputs("   Pbase, Pcheck, Pnext\n", output);
+   fprintf(output, "   {%s, Pbase}, {%s, Pcheck}, {%s, Pnext},\n", ptype[0], ptype[1], ptype[2]);
+   fprintf(output, "   {%s, Gdefault}, {%s, Gbase},\n", gtype[0], gtype[1]);
+
+/* The optional tables follow the parser tables, ending with the last present */
+
+   tail[0] = code ? "Scanner" : "NULL";
+   tail[1] = fused ? "Scanstate" : "NULL";
+   tail[2] = (type == 4) ? "&Nfa" : "NULL";
+   tail[3] = keywords ? "&Keywords" : "NULL";
+   tail[4] = parser ? "Parser" : "NULL";
+   for (last = 5; last > 0 && !strcmp(tail[last - 1], "NULL"); last--)
+      ;
+   if (last)
+   {
+      fprintf(output, "   {%s, Gcheck}, {%s, Gnext},\n   ", gtype[2], gtype[3]);
+      for (i = 0; i < last; i++)
+	 fprintf(output, "%s%s", tail[i], (i < last - 1) ? ", " : "\n");
+   }
+   else
+      fprintf(output, "   {%s, Gcheck}, {%s, Gnext}\n", gtype[2], gtype[3]);
    fputs("};\n", output);
 
    dynfree(&name);